@@ -319,6 +319,10 @@ void GPHGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	// Add the changed parts of the game screen
+	if (!_overlayVisible)
+		flushDirtyTiles();
+
 	// Force a full redraw if requested
 	if (_forceFull) {
 		_numDirtyRects = 1;
@@ -24,12 +24,18 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
 
 static const OSystem::GraphicsMode s_noGraphicsModes[] = { {0, 0, 0} };
 
-class NullGraphicsManager : GraphicsManager {
+/**
+ * Graphics manager which does not display anything. It only keeps the
+ * screen contents around, so engines may still lock the screen.
+ */
+class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	NullGraphicsManager() : _format(Graphics::PixelFormat::createFormatCLUT8()) {}
+	virtual ~NullGraphicsManager() { _screen.free(); }
 
 	bool hasFeature(OSystem::Feature f) { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) {}
@@ -38,27 +44,35 @@ public:
 	const OSystem::GraphicsMode *getSupportedGraphicsModes() const { return s_noGraphicsModes; }
 	int getDefaultGraphicsMode() const { return 0; }
 	bool setGraphicsMode(int mode) { return true; }
+	void resetGraphicsScale() {}
 	int getGraphicsMode() const { return 0; }
 	inline Graphics::PixelFormat getScreenFormat() const {
-		return Graphics::PixelFormat::createFormatCLUT8();
+		return _format;
 	}
 	inline Common::List<Graphics::PixelFormat> getSupportedFormats() const {
 		Common::List<Graphics::PixelFormat> list;
+#ifdef USE_RGB_COLOR
+		list.push_back(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+#endif
 		list.push_back(Graphics::PixelFormat::createFormatCLUT8());
 		return list;
 	}
-	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {
+		_format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+		_screen.free();
+		_screen.create(width, height, _format);
+	}
 	virtual int getScreenChangeID() const { return 0; }
 
 	void beginGFXTransaction() {}
 	OSystem::TransactionError endGFXTransaction() { return OSystem::kTransactionSuccess; }
 
-	int16 getHeight() { return 0; }
-	int16 getWidth() { return 0; }
+	int16 getHeight() { return _screen.h; }
+	int16 getWidth() { return _screen.w; }
 	void setPalette(const byte *colors, uint start, uint num) {}
 	void grabPalette(byte *colors, uint start, uint num) {}
 	void copyRectToScreen(const byte *buf, int pitch, int x, int y, int w, int h) {}
-	Graphics::Surface *lockScreen() { return NULL; }
+	Graphics::Surface *lockScreen() { return &_screen; }
 	void unlockScreen() {}
 	void fillScreen(uint32 col) {}
 	void updateScreen() {}
@@ -79,6 +93,10 @@ public:
 	void warpMouse(int x, int y) {}
 	void setMouseCursor(const byte *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, int cursorTargetScale = 1, const Graphics::PixelFormat *format = NULL) {}
 	void setCursorPalette(const byte *colors, uint start, uint num) {}
+
+private:
+	Graphics::PixelFormat _format;
+	Graphics::Surface _screen;
 };
 
 #endif
@@ -61,6 +61,18 @@ static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 	{0, 0, 0}
 };
 
+/**
+ * Get the best scaler implementation for a graphics mode. The modes have
+ * the same names as the scalers.
+ */
+static const ScalerInfo *getScalerForMode(int mode) {
+	for (const OSystem::GraphicsMode *gm = s_supportedGraphicsModes; gm->name; ++gm) {
+		if (gm->id == mode)
+			return findScaler(gm->name);
+	}
+	return 0;
+}
+
 DECLARE_TRANSLATION_ADDITIONAL_CONTEXT("Normal (no scaling)", "lowres")
 
 // Table of relative scalers magnitudes
@@ -125,6 +137,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	SdlGraphicsManager(sdlEventSource),
 #ifdef USE_OSD
 	_osdSurface(0), _osdAlpha(SDL_ALPHA_TRANSPARENT), _osdFadeStartTime(0),
+	_perfHudSurface(0), _perfHudNeedsRedraw(false),
 #endif
 	_hwscreen(0), _screen(0), _tmpscreen(0),
 #ifdef USE_RGB_COLOR
@@ -133,7 +146,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_overlayVisible(false),
 	_overlayscreen(0), _tmpscreen2(0),
-	_scalerProc(0), _screenChangeCount(0),
+	_scalerProc(0), _scalerIsReentrant(true), _scalerPool(0), _screenshotWriter(0), _screenChangeCount(0),
+	_dirtyTiles(0), _dirtyTilesW(0), _dirtyTilesH(0), _dirtyTileColors(0),
 	_mouseVisible(false), _mouseNeedsRedraw(false), _mouseData(0), _mouseSurface(0),
 	_mouseOrigSurface(0), _cursorTargetScale(1), _cursorPaletteDisabled(true),
 	_currentShakePos(0), _newShakePos(0),
@@ -163,6 +177,20 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	_graphicsMutex = g_system->createMutex();
 
+	// Big updates are scaled in bands, spread over a few worker threads.
+	// They are only started by the first update that needs them.
+	int scalerThreads = 2;
+	if (ConfMan.hasKey("scaler_threads"))
+		scalerThreads = ConfMan.getInt("scaler_threads");
+	_scalerPool = new SdlScalerPool(scalerThreads);
+
+	_screenshotWriter = new SdlScreenshotWriter();
+
+	_perfUpdateTime = g_perfCounters.registerCounter("Screen update ms", Common::PerfCounters::kAveragePerFrame);
+	_perfScalerTime = g_perfCounters.registerCounter("Scaler ms", Common::PerfCounters::kAveragePerFrame);
+	_perfDirtyPixels = g_perfCounters.registerCounter("Dirty pixels", Common::PerfCounters::kAveragePerFrame);
+	_perfFullRedraws = g_perfCounters.registerCounter("Full redraws/s", Common::PerfCounters::kTotalPerSecond);
+
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
@@ -207,7 +235,14 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	if (_mouseOrigSurface)
 		SDL_FreeSurface(_mouseOrigSurface);
 	_mouseOrigSurface = 0;
+#ifdef USE_OSD
+	if (_perfHudSurface)
+		SDL_FreeSurface(_perfHudSurface);
+	_perfHudSurface = 0;
+#endif
 	g_system->deleteMutex(_graphicsMutex);
+	delete _scalerPool;
+	delete _screenshotWriter;
 
 	free(_currentPalette);
 	free(_cursorPalette);
@@ -498,56 +533,14 @@ bool SurfaceSdlGraphicsManager::setGraphicsMode(int mode) {
 	if (_oldVideoMode.setup && _oldVideoMode.mode == mode)
 		return true;
 
-	int newScaleFactor = 1;
-
-	switch (mode) {
-	case GFX_NORMAL:
-		newScaleFactor = 1;
-		break;
-#ifdef USE_SCALERS
-	case GFX_DOUBLESIZE:
-		newScaleFactor = 2;
-		break;
-	case GFX_TRIPLESIZE:
-		newScaleFactor = 3;
-		break;
-
-	case GFX_2XSAI:
-		newScaleFactor = 2;
-		break;
-	case GFX_SUPER2XSAI:
-		newScaleFactor = 2;
-		break;
-	case GFX_SUPEREAGLE:
-		newScaleFactor = 2;
-		break;
-	case GFX_ADVMAME2X:
-		newScaleFactor = 2;
-		break;
-	case GFX_ADVMAME3X:
-		newScaleFactor = 3;
-		break;
-#ifdef USE_HQ_SCALERS
-	case GFX_HQ2X:
-		newScaleFactor = 2;
-		break;
-	case GFX_HQ3X:
-		newScaleFactor = 3;
-		break;
-#endif
-	case GFX_TV2X:
-		newScaleFactor = 2;
-		break;
-	case GFX_DOTMATRIX:
-		newScaleFactor = 2;
-		break;
-#endif // USE_SCALERS
-
-	default:
+	const ScalerInfo *scaler = getScalerForMode(mode);
+	if (!scaler) {
 		warning("unknown gfx mode %d", mode);
 		return false;
 	}
 
+	int newScaleFactor = scaler->factor;
+
 	_transactionDetails.normal1xScaler = (mode == GFX_NORMAL);
 	if (_oldVideoMode.setup && _oldVideoMode.scaleFactor != newScaleFactor)
 		_transactionDetails.needHotswap = true;
@@ -562,56 +555,12 @@ bool SurfaceSdlGraphicsManager::setGraphicsMode(int mode) {
 
 void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	Common::StackLock lock(_graphicsMutex);
-	ScalerProc *newScalerProc = 0;
-
-	switch (_videoMode.mode) {
-	case GFX_NORMAL:
-		newScalerProc = Normal1x;
-		break;
-#ifdef USE_SCALERS
-	case GFX_DOUBLESIZE:
-		newScalerProc = Normal2x;
-		break;
-	case GFX_TRIPLESIZE:
-		newScalerProc = Normal3x;
-		break;
-
-	case GFX_2XSAI:
-		newScalerProc = _2xSaI;
-		break;
-	case GFX_SUPER2XSAI:
-		newScalerProc = Super2xSaI;
-		break;
-	case GFX_SUPEREAGLE:
-		newScalerProc = SuperEagle;
-		break;
-	case GFX_ADVMAME2X:
-		newScalerProc = AdvMame2x;
-		break;
-	case GFX_ADVMAME3X:
-		newScalerProc = AdvMame3x;
-		break;
-#ifdef USE_HQ_SCALERS
-	case GFX_HQ2X:
-		newScalerProc = HQ2x;
-		break;
-	case GFX_HQ3X:
-		newScalerProc = HQ3x;
-		break;
-#endif
-	case GFX_TV2X:
-		newScalerProc = TV2x;
-		break;
-	case GFX_DOTMATRIX:
-		newScalerProc = DotMatrix;
-		break;
-#endif // USE_SCALERS
-
-	default:
+	const ScalerInfo *scaler = getScalerForMode(_videoMode.mode);
+	if (!scaler)
 		error("Unknown gfx mode %d", _videoMode.mode);
-	}
 
-	_scalerProc = newScalerProc;
+	_scalerProc = scaler->proc;
+	_scalerIsReentrant = scaler->reentrant;
 
 	if (_videoMode.mode != GFX_NORMAL) {
 		for (int i = 0; i < ARRAYSIZE(s_gfxModeSwitchTable); i++) {
@@ -761,6 +710,8 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	// SDL_SetColors does nothing for non indexed surfaces.
 	SDL_SetColors(_screen, _currentPalette, 0, 256);
 
+	setupDirtyTiles();
+
 	//
 	// Create the surface that contains the scaled graphics in 16 bit mode
 	//
@@ -894,6 +845,7 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		_osdSurface = NULL;
 	}
 #endif
+	freeDirtyTiles();
 	DestroyScalers();
 }
 
@@ -962,6 +914,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	int height, width;
 	ScalerProc *scalerProc;
 	int scale1;
+	const uint32 updateStart = SDL_GetTicks();
 
 	// definitions not available for non-DEBUG here. (needed this to compile in SYMBIAN32 & linux?)
 #if defined (DEBUG) && !defined(WIN32) && !defined(_WIN32_WCE)
@@ -991,9 +944,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 			_paletteDirtyStart,
 			_paletteDirtyEnd - _paletteDirtyStart);
 
-		_paletteDirtyEnd = 0;
+		// Only redraw the parts of the screen using the changed colors
+		markPaletteDirtyTiles(_paletteDirtyStart, _paletteDirtyEnd);
 
-		_forceFull = true;
+		_paletteDirtyStart = 256;
+		_paletteDirtyEnd = 0;
 	}
 
 #ifdef USE_OSD
@@ -1038,8 +993,13 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_mouseNeedsRedraw)
 		undrawMouse();
 
+	// Add the changed parts of the game screen
+	if (!_overlayVisible)
+		flushDirtyTiles();
+
 	// Force a full redraw if requested
 	if (_forceFull) {
+		g_perfCounters.add(_perfFullRedraws, 1);
 		_numDirtyRects = 1;
 		_dirtyRectList[0].x = 0;
 		_dirtyRectList[0].y = 0;
@@ -1048,7 +1008,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	}
 
 	// Only draw anything if necessary
-	if (_numDirtyRects > 0 || _mouseNeedsRedraw) {
+	const bool redraw = (_numDirtyRects > 0 || _mouseNeedsRedraw);
+	if (redraw) {
 		SDL_Rect *r;
 		SDL_Rect dst;
 		uint32 srcPitch, dstPitch;
@@ -1069,6 +1030,14 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwscreen->pitch;
 
+		// Only hand out the real scalers to the worker threads. Plain 1x
+		// copies are not worth it, and some scalers keep their state in
+		// global variables.
+		const bool useScalerPool = (scale1 > 1 && _scalerIsReentrant);
+
+		const uint32 scalerStart = SDL_GetTicks();
+		uint32 dirtyPixels = 0;
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			register int dst_y = r->y + _currentShakePos;
 			register int dst_h = 0;
@@ -1087,10 +1056,16 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+				const byte *srcPtr = (byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch;
+				byte *dstPtr = (byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch;
+				if (useScalerPool)
+					_scalerPool->scale(scalerProc, srcPtr, srcPitch, dstPtr, dstPitch, r->w, dst_h, scale1);
+				else
+					scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, r->w, dst_h);
 			}
 
+			dirtyPixels += r->w * dst_h;
+
 			r->x = rx1;
 			r->y = dst_y;
 			r->w = r->w * scale1;
@@ -1104,6 +1079,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwscreen);
 
+		g_perfCounters.add(_perfScalerTime, SDL_GetTicks() - scalerStart);
+		g_perfCounters.add(_perfDirtyPixels, dirtyPixels);
+
 		// Readjust the dirty rect list in case we are doing a full update.
 		// This is necessary if shaking is active.
 		if (_forceFull) {
@@ -1191,20 +1169,48 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		}
 #endif
 
+#ifdef USE_OSD
+		// The performance overlay goes on top of everything else
+		if (_perfHudSurface)
+			SDL_BlitSurface(_perfHudSurface, 0, _hwscreen, 0);
+#endif
+
 		// Finally, blit all our changes to the screen
 		SDL_UpdateRects(_hwscreen, _numDirtyRects, _dirtyRectList);
 	}
 
+#ifdef USE_OSD
+	// The overlay is not necessarily covered by the dirty rects, so it is
+	// updated separately, also when only its values changed.
+	if (_perfHudSurface && (redraw || _perfHudNeedsRedraw)) {
+		if (!redraw)
+			SDL_BlitSurface(_perfHudSurface, 0, _hwscreen, 0);
+		SDL_UpdateRect(_hwscreen, 0, 0, _perfHudSurface->w, _perfHudSurface->h);
+		_perfHudNeedsRedraw = false;
+	}
+#endif
+
 	_numDirtyRects = 0;
 	_forceFull = false;
 	_mouseNeedsRedraw = false;
+
+	g_perfCounters.add(_perfUpdateTime, SDL_GetTicks() - updateStart);
+	if (g_perfCounters.frameDone(SDL_GetTicks())) {
+#ifdef USE_OSD
+		if (_perfHudSurface)
+			drawPerfHud();
+#endif
+	}
 }
 
 bool SurfaceSdlGraphicsManager::saveScreenshot(const char *filename) {
 	assert(_hwscreen != NULL);
 
 	Common::StackLock lock(_graphicsMutex);	// Lock the mutex until this function ends
-	return SDL_SaveBMP(_hwscreen, filename) == 0;
+
+	// Only the copy of the screen is made here, the file is written
+	// in the background
+	return _screenshotWriter->save(_hwscreen, filename);
 }
 
 void SurfaceSdlGraphicsManager::setFullscreenMode(bool enable) {
@@ -1247,12 +1253,17 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const byte *src, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
-	addDirtyRect(x, y, w, h);
-
 	// Try to lock the screen surface
 	if (SDL_LockSurface(_screen) == -1)
 		error("SDL_LockSurface failed: %s", SDL_GetError());
 
+	// Many engines copy the whole frame every time, so compare it with
+	// the current screen contents to find out what really changed.
+	if (_dirtyTiles)
+		diffDirtyTiles(src, pitch, x, y, w, h);
+	else
+		addDirtyRect(x, y, w, h);
+
 #ifdef USE_RGB_COLOR
 	byte *dst = (byte *)_screen->pixels + y * _screen->pitch + x * _screenFormat.bytesPerPixel;
 	if (_videoMode.screenWidth == w && pitch == _screen->pitch) {
@@ -1318,8 +1329,10 @@ void SurfaceSdlGraphicsManager::unlockScreen() {
 	// Unlock the screen surface
 	SDL_UnlockSurface(_screen);
 
-	// Trigger a full screen update
+	// Trigger a full screen update. All tiles are marked as well, since
+	// their color masks need to be rebuilt.
 	_forceFull = true;
+	markDirtyTiles(0, 0, _videoMode.screenWidth, _videoMode.screenHeight);
 
 	// Finally unlock the graphics mutex
 	g_system->unlockMutex(_graphicsMutex);
@@ -1400,6 +1413,156 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	}
 }
 
+void SurfaceSdlGraphicsManager::setupDirtyTiles() {
+	freeDirtyTiles();
+
+	_dirtyTilesW = (_videoMode.screenWidth + kDirtyTileSize - 1) / kDirtyTileSize;
+	_dirtyTilesH = (_videoMode.screenHeight + kDirtyTileSize - 1) / kDirtyTileSize;
+
+	// All tiles start out dirty, so their color masks get built on the
+	// first screen update
+	_dirtyTiles = (byte *)malloc(_dirtyTilesW * _dirtyTilesH);
+	memset(_dirtyTiles, 1, _dirtyTilesW * _dirtyTilesH);
+
+#ifdef USE_RGB_COLOR
+	if (_screenFormat.bytesPerPixel == 1)
+#endif
+		_dirtyTileColors = (uint32 *)calloc(_dirtyTilesW * _dirtyTilesH * kDirtyTileColorWords, sizeof(uint32));
+}
+
+void SurfaceSdlGraphicsManager::freeDirtyTiles() {
+	free(_dirtyTiles);
+	_dirtyTiles = 0;
+	free(_dirtyTileColors);
+	_dirtyTileColors = 0;
+}
+
+void SurfaceSdlGraphicsManager::markDirtyTiles(int x, int y, int w, int h) {
+	if (!_dirtyTiles) {
+		addDirtyRect(x, y, w, h);
+		return;
+	}
+
+	const int tx1 = x / kDirtyTileSize, tx2 = (x + w - 1) / kDirtyTileSize;
+	const int ty1 = y / kDirtyTileSize, ty2 = (y + h - 1) / kDirtyTileSize;
+
+	for (int ty = ty1; ty <= ty2; ++ty)
+		memset(_dirtyTiles + ty * _dirtyTilesW + tx1, 1, tx2 - tx1 + 1);
+}
+
+void SurfaceSdlGraphicsManager::diffDirtyTiles(const byte *src, int pitch, int x, int y, int w, int h) {
+#ifdef USE_RGB_COLOR
+	const int bpp = _screenFormat.bytesPerPixel;
+#else
+	const int bpp = 1;
+#endif
+	const byte *dst = (const byte *)_screen->pixels + y * _screen->pitch + x * bpp;
+	const int tx1 = x / kDirtyTileSize, tx2 = (x + w - 1) / kDirtyTileSize;
+
+	for (int row = y; row < y + h; ++row) {
+		byte *tiles = _dirtyTiles + (row / kDirtyTileSize) * _dirtyTilesW;
+
+		// Compare the row piece by piece, skipping tiles already known
+		// to be dirty
+		int x1 = x;
+		for (int tx = tx1; tx <= tx2; ++tx) {
+			const int x2 = MIN<int>((tx + 1) * kDirtyTileSize, x + w);
+			const int offset = (x1 - x) * bpp;
+			if (!tiles[tx] && memcmp(src + offset, dst + offset, (x2 - x1) * bpp))
+				tiles[tx] = 1;
+			x1 = x2;
+		}
+
+		src += pitch;
+		dst += _screen->pitch;
+	}
+}
+
+void SurfaceSdlGraphicsManager::markPaletteDirtyTiles(uint start, uint end) {
+	if (!_dirtyTileColors) {
+		_forceFull = true;
+		return;
+	}
+
+	uint32 changed[kDirtyTileColorWords];
+	memset(changed, 0, sizeof(changed));
+	for (uint color = start; color < end; ++color)
+		changed[color >> 5] |= 1U << (color & 31);
+
+	const int numTiles = _dirtyTilesW * _dirtyTilesH;
+	const uint32 *colors = _dirtyTileColors;
+	for (int tile = 0; tile < numTiles; ++tile, colors += kDirtyTileColorWords) {
+		if (_dirtyTiles[tile])
+			continue;
+
+		for (int i = 0; i < kDirtyTileColorWords; ++i) {
+			if (colors[i] & changed[i]) {
+				_dirtyTiles[tile] = 1;
+				break;
+			}
+		}
+	}
+}
+
+void SurfaceSdlGraphicsManager::updateTileColors(int tx, int ty) {
+	uint32 *colors = _dirtyTileColors + (ty * _dirtyTilesW + tx) * kDirtyTileColorWords;
+	memset(colors, 0, kDirtyTileColorWords * sizeof(uint32));
+
+	const int x = tx * kDirtyTileSize, y = ty * kDirtyTileSize;
+	const int w = MIN<int>(kDirtyTileSize, _videoMode.screenWidth - x);
+	const int h = MIN<int>(kDirtyTileSize, _videoMode.screenHeight - y);
+	const byte *src = (const byte *)_screen->pixels + y * _screen->pitch + x;
+
+	for (int row = 0; row < h; ++row, src += _screen->pitch) {
+		for (int col = 0; col < w; ++col)
+			colors[src[col] >> 5] |= 1U << (src[col] & 31);
+	}
+}
+
+void SurfaceSdlGraphicsManager::flushDirtyTiles() {
+	if (!_dirtyTiles)
+		return;
+
+	if (_dirtyTileColors && SDL_LockSurface(_screen) == -1)
+		error("SDL_LockSurface failed: %s", SDL_GetError());
+
+	for (int ty = 0; ty < _dirtyTilesH; ++ty) {
+		byte *tiles = _dirtyTiles + ty * _dirtyTilesW;
+
+		for (int tx = 0; tx < _dirtyTilesW; ++tx) {
+			if (!tiles[tx])
+				continue;
+
+			// Take the run of dirty tiles starting here, and extend it
+			// downwards as long as all tiles below it are dirty, too.
+			int tx2 = tx + 1;
+			while (tx2 < _dirtyTilesW && tiles[tx2])
+				++tx2;
+
+			int ty2 = ty + 1;
+			while (ty2 < _dirtyTilesH && !memchr(_dirtyTiles + ty2 * _dirtyTilesW + tx, 0, tx2 - tx))
+				++ty2;
+
+			for (int y = ty; y < ty2; ++y) {
+				memset(_dirtyTiles + y * _dirtyTilesW + tx, 0, tx2 - tx);
+				if (_dirtyTileColors) {
+					for (int x = tx; x < tx2; ++x)
+						updateTileColors(x, y);
+				}
+			}
+
+			// addDirtyRect clips the rect against the screen size
+			addDirtyRect(tx * kDirtyTileSize, ty * kDirtyTileSize,
+			             (tx2 - tx) * kDirtyTileSize, (ty2 - ty) * kDirtyTileSize);
+
+			tx = tx2 - 1;
+		}
+	}
+
+	if (_dirtyTileColors)
+		SDL_UnlockSurface(_screen);
+}
+
 int16 SurfaceSdlGraphicsManager::getHeight() {
 	return _videoMode.screenHeight;
 }
@@ -2130,10 +2293,93 @@ void SurfaceSdlGraphicsManager::displayMessageOnOSD(const char *msg) {
 	// Ensure a full redraw takes place next time the screen is updated
 	_forceFull = true;
 }
+
+void SurfaceSdlGraphicsManager::togglePerfHud() {
+	Common::StackLock lock(_graphicsMutex);	// Lock the mutex until this function ends
+
+	if (_perfHudSurface) {
+		SDL_FreeSurface(_perfHudSurface);
+		_perfHudSurface = 0;
+		g_perfCounters.setEnabled(false);
+
+		// Get rid of the overlay on the screen
+		_forceFull = true;
+	} else {
+		g_perfCounters.setEnabled(true);
+		drawPerfHud();
+	}
+}
+
+void SurfaceSdlGraphicsManager::drawPerfHud() {
+	const Graphics::Font *font = FontMan.getFontByUsage(Graphics::FontManager::kConsoleFont);
+
+	Common::Array<Common::String> lines;
+	lines.push_back(Common::String::format("FPS: %.1f", g_perfCounters.getFrameRate()));
+	for (uint i = 0; i < g_perfCounters.getNumCounters(); i++)
+		lines.push_back(Common::String::format("%s: %.1f", g_perfCounters.getName(i).c_str(), g_perfCounters.getValue(i)));
+
+	const int border = 2;
+	const int lineHeight = font->getFontHeight() + 1;
+	int width = 0;
+	int height = lineHeight * lines.size() + 2 * border;
+	for (uint i = 0; i < lines.size(); i++)
+		width = MAX(width, font->getStringWidth(lines[i]) + 2 * border);
+
+	// The overlay only ever grows, so no leftovers of it stay on the screen
+	if (!_perfHudSurface || _perfHudSurface->w < width || _perfHudSurface->h < height) {
+		if (_perfHudSurface) {
+			width = MAX<int>(width, _perfHudSurface->w);
+			height = MAX<int>(height, _perfHudSurface->h);
+			SDL_FreeSurface(_perfHudSurface);
+		}
+
+		_perfHudSurface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+						width, height, 16,
+						_hwscreen->format->Rmask,
+						_hwscreen->format->Gmask,
+						_hwscreen->format->Bmask,
+						_hwscreen->format->Amask);
+		if (_perfHudSurface == NULL)
+			error("allocating _perfHudSurface failed");
+	}
+
+	SDL_FillRect(_perfHudSurface, 0, SDL_MapRGB(_perfHudSurface->format, 32, 32, 32));
+
+	if (SDL_LockSurface(_perfHudSurface))
+		error("drawPerfHud: SDL_LockSurface failed: %s", SDL_GetError());
+
+	Graphics::Surface dst;
+	dst.pixels = _perfHudSurface->pixels;
+	dst.w = _perfHudSurface->w;
+	dst.h = _perfHudSurface->h;
+	dst.pitch = _perfHudSurface->pitch;
+	dst.format = Graphics::PixelFormat(_perfHudSurface->format->BytesPerPixel,
+	                                   8 - _perfHudSurface->format->Rloss, 8 - _perfHudSurface->format->Gloss,
+	                                   8 - _perfHudSurface->format->Bloss, 8 - _perfHudSurface->format->Aloss,
+	                                   _perfHudSurface->format->Rshift, _perfHudSurface->format->Gshift,
+	                                   _perfHudSurface->format->Bshift, _perfHudSurface->format->Ashift);
+
+	for (uint i = 0; i < lines.size(); i++) {
+		font->drawString(&dst, lines[i], border, border + i * lineHeight, dst.w - 2 * border,
+							SDL_MapRGB(_perfHudSurface->format, 255, 255, 255));
+	}
+
+	SDL_UnlockSurface(_perfHudSurface);
+
+	_perfHudNeedsRedraw = true;
+}
 #endif
 
 bool SurfaceSdlGraphicsManager::handleScalerHotkeys(Common::KeyCode key) {
 
+#ifdef USE_OSD
+	// Ctrl-Alt-p toggles the performance overlay
+	if (key == 'p') {
+		togglePerfHud();
+		return true;
+	}
+#endif
+
 	// Ctrl-Alt-a toggles aspect ratio correction
 	if (key == 'a') {
 		beginGFXTransaction();
@@ -2233,7 +2479,7 @@ bool SurfaceSdlGraphicsManager::isScalerHotkey(const Common::Event &event) {
 			if (keyValue >= ARRAYSIZE(s_gfxModeSwitchTable))
 				return false;
 		}
-		return (isScaleKey || event.kbd.keycode == 'a');
+		return (isScaleKey || event.kbd.keycode == 'a' || event.kbd.keycode == 'p');
 	}
 	return false;
 }
@@ -2270,8 +2516,12 @@ bool SurfaceSdlGraphicsManager::notifyEvent(const Common::Event &event) {
 
 				sprintf(filename, "scummvm%05d.bmp", n);
 				file = SDL_RWFromFile(filename, "r");
-				if (!file)
-					break;
+				if (!file) {
+					// The previous screenshot may not have been written yet
+					if (!_screenshotWriter->isPending(filename))
+						break;
+					continue;
+				}
 				SDL_RWclose(file);
 			}
 			if (saveScreenshot(filename))
@@ -28,9 +28,12 @@
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
+#include "common/perfcounters.h"
 #include "common/system.h"
 
 #include "backends/events/sdl/sdl-events.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
+#include "backends/graphics/surfacesdl/surfacesdl-screenshot.h"
 
 #include "backends/platform/sdl/sdl-sys.h"
 
@@ -161,8 +164,19 @@ protected:
 		kOSDColorKey = 1,				/** < Transparent color key */
 		kOSDInitialAlpha = 80			/** < Initial alpha level, in percent */
 	};
+
+	/** Surface containing the performance overlay, or 0 if it is hidden */
+	SDL_Surface *_perfHudSurface;
+	/** Whether the performance overlay changed since it was last shown */
+	bool _perfHudNeedsRedraw;
+
+	void togglePerfHud();
+	void drawPerfHud();
 #endif
 
+	/** Counters shown in the performance overlay */
+	Common::PerfCounters::CounterId _perfUpdateTime, _perfScalerTime, _perfDirtyPixels, _perfFullRedraws;
+
 	/** Hardware screen */
 	SDL_Surface *_hwscreen;
 
@@ -229,7 +243,15 @@ protected:
 	bool _forceFull;
 
 	ScalerProc *_scalerProc;
+	/** Whether _scalerProc may be run by several threads at once */
+	bool _scalerIsReentrant;
 	int _scalerType;
+
+	/** Worker threads which share the scaling of big dirty rects */
+	SdlScalerPool *_scalerPool;
+
+	/** Writes the screenshots in the background */
+	SdlScreenshotWriter *_screenshotWriter;
 	int _transactionMode;
 
 	bool _screenIsLocked;
@@ -246,6 +268,26 @@ protected:
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	enum {
+		kDirtyTileSize = 16,
+		kDirtyTileColorWords = 256 / 32
+	};
+
+	/**
+	 * Dirty tiles of the game screen. copyRectToScreen only marks the
+	 * tiles whose contents really changed, and they are turned into
+	 * dirty rects by flushDirtyTiles() on the next screen update.
+	 */
+	byte *_dirtyTiles;
+	int _dirtyTilesW, _dirtyTilesH;
+
+	/**
+	 * For CLUT8 screens, a bitmask of the colors used in each tile, so a
+	 * palette change only redraws the tiles using the changed colors.
+	 * The masks are only valid for tiles which are not marked dirty.
+	 */
+	uint32 *_dirtyTileColors;
+
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
 		// (overlay) coordinates.
@@ -314,6 +356,14 @@ protected:
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
 
+	void setupDirtyTiles();
+	void freeDirtyTiles();
+	void markDirtyTiles(int x, int y, int w, int h);
+	void diffDirtyTiles(const byte *src, int pitch, int x, int y, int w, int h);
+	void markPaletteDirtyTiles(uint start, uint end);
+	void updateTileColors(int tx, int ty);
+	void flushDirtyTiles();
+
 	virtual void drawMouse();
 	virtual void undrawMouse();
 	virtual void blitCursor();
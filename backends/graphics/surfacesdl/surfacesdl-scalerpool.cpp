@@ -0,0 +1,154 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+SdlScalerPool::SdlScalerPool(int numThreads)
+	: _numThreads(MAX(numThreads, 0)), _threadsStarted(false), _nextJob(0), _pendingJobs(0), _quit(false) {
+
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+}
+
+SdlScalerPool::~SdlScalerPool() {
+	// Signal the workers to end, and wait for them to actually finish
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_workCond);
+	SDL_UnlockMutex(_mutex);
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		SDL_WaitThread(_threads[i], NULL);
+
+	SDL_DestroyCond(_doneCond);
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyMutex(_mutex);
+}
+
+void SdlScalerPool::startThreads() {
+	_threadsStarted = true;
+
+	for (int i = 0; i < _numThreads; ++i) {
+		SDL_Thread *thread = SDL_CreateThread(workerThreadEntry, this);
+		if (!thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+int SdlScalerPool::getBandHeight(int height, int numBands) {
+	// Bands have to start on even lines: the DotMatrix scaler picks its
+	// pattern based on the line number relative to the start of the rect.
+	return (((height + numBands - 1) / numBands) + 1) & ~1;
+}
+
+void SdlScalerPool::scale(ScalerProc *scalerProc, const uint8 *srcPtr, uint32 srcPitch,
+		uint8 *dstPtr, uint32 dstPitch, int width, int height, int scaleFactor) {
+
+	if (_numThreads == 0 || getBandHeight(height, _numThreads + 1) < kMinBandHeight) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	// The threads are only started once there is work for them, so
+	// backends which never scale through the pool don't keep idle threads
+	if (!_threadsStarted)
+		startThreads();
+
+	const int numBands = _threads.size() + 1;
+	const int bandHeight = getBandHeight(height, numBands);
+
+	if (numBands == 1 || bandHeight < kMinBandHeight) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+
+	_jobs.resize(0);
+	for (int y = 0; y < height; ) {
+		// Some scalers need at least two lines, so never leave a single
+		// line for the last band
+		int h = height - y;
+		if (h >= bandHeight + 2)
+			h = bandHeight;
+
+		Job job;
+		job.scalerProc = scalerProc;
+		job.srcPtr = srcPtr + y * srcPitch;
+		job.srcPitch = srcPitch;
+		job.dstPtr = dstPtr + y * scaleFactor * dstPitch;
+		job.dstPitch = dstPitch;
+		job.width = width;
+		job.height = h;
+		_jobs.push_back(job);
+
+		y += h;
+	}
+	_nextJob = 0;
+	_pendingJobs = _jobs.size();
+	SDL_CondBroadcast(_workCond);
+
+	// Lend a hand, then wait until the workers have finished their bands
+	while (runNextJob())
+		;
+	while (_pendingJobs)
+		SDL_CondWait(_doneCond, _mutex);
+
+	SDL_UnlockMutex(_mutex);
+}
+
+bool SdlScalerPool::runNextJob() {
+	if (_nextJob >= _jobs.size())
+		return false;
+
+	const Job job = _jobs[_nextJob++];
+
+	SDL_UnlockMutex(_mutex);
+	job.scalerProc(job.srcPtr, job.srcPitch, job.dstPtr, job.dstPitch, job.width, job.height);
+	SDL_LockMutex(_mutex);
+
+	if (--_pendingJobs == 0)
+		SDL_CondSignal(_doneCond);
+	return true;
+}
+
+void SdlScalerPool::workerThread() {
+	SDL_LockMutex(_mutex);
+	while (!_quit) {
+		if (!runNextJob())
+			SDL_CondWait(_workCond, _mutex);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+int SDLCALL SdlScalerPool::workerThreadEntry(void *arg) {
+	SdlScalerPool *pool = (SdlScalerPool *)arg;
+	assert(pool);
+	pool->workerThread();
+	return 0;
+}
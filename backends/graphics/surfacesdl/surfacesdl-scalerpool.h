@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "graphics/scaler.h"
+#include "common/array.h"
+
+/**
+ * A small pool of persistent worker threads which run a scaler over
+ * horizontal bands of a rectangle in parallel.
+ *
+ * Every band reads its source lines (plus the lines around them that the
+ * scalers look at) from the unmodified source surface and writes a disjoint
+ * range of destination lines, so the result is identical to scaling the
+ * whole rectangle in one go.
+ */
+class SdlScalerPool {
+public:
+	/**
+	 * @param numThreads	number of worker threads to use; the thread
+	 *			calling scale() works on a band as well. They
+	 *			are started by the first scale() call that
+	 *			splits a rectangle.
+	 */
+	SdlScalerPool(int numThreads);
+	~SdlScalerPool();
+
+	/**
+	 * Scale a rectangle, splitting it into bands for the worker threads.
+	 * The parameters are the same as the ones of ScalerProc. Returns once
+	 * all bands have been scaled.
+	 */
+	void scale(ScalerProc *scalerProc, const uint8 *srcPtr, uint32 srcPitch,
+			uint8 *dstPtr, uint32 dstPitch, int width, int height, int scaleFactor);
+
+private:
+	struct Job {
+		ScalerProc *scalerProc;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width;
+		int height;
+	};
+
+	enum {
+		/** Minimal band height, smaller rectangles are not worth splitting */
+		kMinBandHeight = 16
+	};
+
+	int _numThreads;
+	bool _threadsStarted;
+	Common::Array<SDL_Thread *> _threads;
+	SDL_mutex *_mutex;
+	/** Signalled when new jobs are queued, or the workers should quit */
+	SDL_cond *_workCond;
+	/** Signalled when the last pending job has been finished */
+	SDL_cond *_doneCond;
+
+	Common::Array<Job> _jobs;
+	uint _nextJob;
+	uint _pendingJobs;
+	bool _quit;
+
+	void startThreads();
+	static int getBandHeight(int height, int numBands);
+
+	/** Take the next queued job and run it. Must be called with the mutex held. */
+	bool runNextJob();
+
+	void workerThread();
+	static int SDLCALL workerThreadEntry(void *arg);
+};
+
+#endif
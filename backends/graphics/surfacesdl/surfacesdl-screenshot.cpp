@@ -0,0 +1,155 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/graphics/surfacesdl/surfacesdl-screenshot.h"
+#include "common/textconsole.h"
+
+SdlScreenshotWriter::SdlScreenshotWriter()
+	: _quit(false) {
+
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+
+	_thread = SDL_CreateThread(workerThreadEntry, this);
+	if (!_thread)
+		warning("Could not create screenshot thread: %s", SDL_GetError());
+}
+
+SdlScreenshotWriter::~SdlScreenshotWriter() {
+	// The worker finishes the pending jobs before it quits
+	if (_thread) {
+		SDL_LockMutex(_mutex);
+		_quit = true;
+		SDL_CondSignal(_workCond);
+		SDL_UnlockMutex(_mutex);
+
+		SDL_WaitThread(_thread, NULL);
+	}
+
+	for (uint i = 0; i < _freeSurfaces.size(); ++i)
+		SDL_FreeSurface(_freeSurfaces[i]);
+
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyMutex(_mutex);
+}
+
+bool SdlScreenshotWriter::save(SDL_Surface *surface, const Common::String &filename) {
+	// Without a worker thread, fall back to saving directly
+	if (!_thread)
+		return SDL_SaveBMP(surface, filename.c_str()) == 0;
+
+	SDL_LockMutex(_mutex);
+
+	if (_jobs.size() >= kMaxPendingJobs) {
+		SDL_UnlockMutex(_mutex);
+		warning("Too many screenshots pending");
+		return false;
+	}
+
+	Job job;
+	job.surface = allocSurface(surface);
+	job.filename = filename;
+	if (!job.surface || SDL_BlitSurface(surface, NULL, job.surface, NULL) != 0) {
+		if (job.surface)
+			SDL_FreeSurface(job.surface);
+		SDL_UnlockMutex(_mutex);
+		return false;
+	}
+
+	_jobs.push_back(job);
+	SDL_CondSignal(_workCond);
+
+	SDL_UnlockMutex(_mutex);
+	return true;
+}
+
+bool SdlScreenshotWriter::isPending(const Common::String &filename) {
+	SDL_LockMutex(_mutex);
+
+	bool pending = false;
+	for (Common::List<Job>::const_iterator i = _jobs.begin(); i != _jobs.end(); ++i) {
+		if (i->filename == filename) {
+			pending = true;
+			break;
+		}
+	}
+
+	SDL_UnlockMutex(_mutex);
+	return pending;
+}
+
+SDL_Surface *SdlScreenshotWriter::allocSurface(SDL_Surface *surface) {
+	const SDL_PixelFormat *format = surface->format;
+
+	while (!_freeSurfaces.empty()) {
+		SDL_Surface *buffer = _freeSurfaces.back();
+		_freeSurfaces.pop_back();
+
+		// Buffers from before a video mode change are of no use anymore
+		if (buffer->w == surface->w && buffer->h == surface->h &&
+		    buffer->format->BitsPerPixel == format->BitsPerPixel &&
+		    buffer->format->Rmask == format->Rmask &&
+		    buffer->format->Gmask == format->Gmask &&
+		    buffer->format->Bmask == format->Bmask)
+			return buffer;
+
+		SDL_FreeSurface(buffer);
+	}
+
+	return SDL_CreateRGBSurface(SDL_SWSURFACE, surface->w, surface->h, format->BitsPerPixel,
+	                            format->Rmask, format->Gmask, format->Bmask, format->Amask);
+}
+
+void SdlScreenshotWriter::workerThread() {
+	SDL_LockMutex(_mutex);
+	for (;;) {
+		if (_jobs.empty()) {
+			if (_quit)
+				break;
+			SDL_CondWait(_workCond, _mutex);
+			continue;
+		}
+
+		// The job stays in the queue while it's written, so isPending()
+		// still knows about its file name
+		const Job job = _jobs.front();
+
+		SDL_UnlockMutex(_mutex);
+		if (SDL_SaveBMP(job.surface, job.filename.c_str()) != 0)
+			warning("Could not save screenshot '%s'", job.filename.c_str());
+		SDL_LockMutex(_mutex);
+
+		_jobs.pop_front();
+		if (_freeSurfaces.size() < kMaxFreeSurfaces)
+			_freeSurfaces.push_back(job.surface);
+		else
+			SDL_FreeSurface(job.surface);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+int SDLCALL SdlScreenshotWriter::workerThreadEntry(void *arg) {
+	SdlScreenshotWriter *writer = (SdlScreenshotWriter *)arg;
+	assert(writer);
+	writer->workerThread();
+	return 0;
+}
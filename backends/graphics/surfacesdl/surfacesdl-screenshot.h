@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCREENSHOT_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCREENSHOT_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/str.h"
+
+/**
+ * Writes screenshots on a separate thread.
+ *
+ * save() only copies the screen into a buffer, which is then written to
+ * disk by a worker thread, so taking a screenshot does not stall the
+ * screen updates. The buffers are reused for the following screenshots.
+ *
+ * TODO: This only handles screenshots. Savegame thumbnails are still
+ * created synchronously (see Graphics::saveThumbnail()), and there is no
+ * continuous frame and audio dump of a play session yet; that needs a
+ * recording format and a hook into the mixer first.
+ */
+class SdlScreenshotWriter {
+public:
+	SdlScreenshotWriter();
+
+	/** Writes all pending screenshots before returning. */
+	~SdlScreenshotWriter();
+
+	/**
+	 * Copy the surface and queue it for saving as a BMP file. Returns
+	 * false if too many screenshots are pending already.
+	 */
+	bool save(SDL_Surface *surface, const Common::String &filename);
+
+	/** Check whether a screenshot with this name still has to be written. */
+	bool isPending(const Common::String &filename);
+
+private:
+	struct Job {
+		SDL_Surface *surface;
+		Common::String filename;
+	};
+
+	enum {
+		kMaxPendingJobs = 4,
+		kMaxFreeSurfaces = 2
+	};
+
+	SDL_Thread *_thread;
+	SDL_mutex *_mutex;
+	/** Signalled when a new job is queued, or the worker should quit */
+	SDL_cond *_workCond;
+
+	Common::List<Job> _jobs;
+	/** Buffers of finished jobs, for reuse */
+	Common::Array<SDL_Surface *> _freeSurfaces;
+	bool _quit;
+
+	/** Get a buffer with the same size and format as the surface. Must be called with the mutex held. */
+	SDL_Surface *allocSurface(SDL_Surface *surface);
+
+	void workerThread();
+	static int SDLCALL workerThreadEntry(void *arg);
+};
+
+#endif
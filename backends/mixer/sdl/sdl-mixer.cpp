@@ -42,6 +42,8 @@ SdlMixerManager::SdlMixerManager()
 	_mixer(0),
 	_audioSuspended(false) {
 
+	_perfMixTime = g_perfCounters.registerCounter("Mixer ms", Common::PerfCounters::kAveragePerFrame);
+	_perfUnderruns = g_perfCounters.registerCounter("Audio underruns/s", Common::PerfCounters::kTotalPerSecond);
 }
 
 SdlMixerManager::~SdlMixerManager() {
@@ -142,7 +144,16 @@ void SdlMixerManager::sdlCallback(void *this_, byte *samples, int len) {
 	SdlMixerManager *manager = (SdlMixerManager *)this_;
 	assert(manager);
 
+	const uint32 start = SDL_GetTicks();
 	manager->callbackHandler(samples, len);
+	const uint32 mixTime = SDL_GetTicks() - start;
+
+	// When mixing a buffer takes longer than playing it, the sound card
+	// runs out of data.
+	const uint32 frames = len / (2 * manager->_obtained.channels);
+	g_perfCounters.add(manager->_perfMixTime, mixTime);
+	if (mixTime * manager->_obtained.freq > frames * 1000)
+		g_perfCounters.add(manager->_perfUnderruns, 1);
 }
 
 void SdlMixerManager::suspendAudio() {
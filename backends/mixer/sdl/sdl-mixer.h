@@ -25,6 +25,7 @@
 
 #include "backends/platform/sdl/sdl-sys.h"
 #include "audio/mixer_intern.h"
+#include "common/perfcounters.h"
 
 /**
  * SDL mixer manager. It wraps the actual implementation
@@ -72,6 +73,9 @@ protected:
 	/** State of the audio system */
 	bool _audioSuspended;
 
+	/** Counters for the time spent mixing, and for buffers mixed too late */
+	Common::PerfCounters::CounterId _perfMixTime, _perfUnderruns;
+
 	/**
 	 * Returns the desired audio specification
 	 */
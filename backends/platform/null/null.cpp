@@ -20,15 +20,30 @@
  *
  */
 
+#define FORBIDDEN_SYMBOL_EXCEPTION_FILE
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_fputs
+#define FORBIDDEN_SYMBOL_EXCEPTION_stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+
 #include "backends/modular-backend.h"
 #include "base/main.h"
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
+#include "backends/events/default/default-events.h"
+#include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
 #include "audio/mixer_intern.h"
+#include "common/config-manager.h"
+#include "common/EventRecorder.h"
 #include "common/scummsys.h"
 
+#if defined(POSIX)
+#include <sys/resource.h>
+#endif
+
 /*
  * Include header files needed for the getFilesystemFactory() method.
  */
@@ -40,23 +55,56 @@
 	#include "backends/fs/windows/windows-fs-factory.h"
 #endif
 
-class OSystem_NULL : public ModularBackend {
+/*
+ * The NULL backend runs on a virtual clock: delays don't sleep but advance
+ * the clock, and fire the timers and mix the sound for the time passed.
+ * Together with event recorder playback this allows running a recorded
+ * session as fast as possible, and the same way every time. With the
+ * "benchmark" option set, ScummVM quits when the playback is over and
+ * reports how many frames were drawn and how much CPU time and memory
+ * were used.
+ */
+class OSystem_NULL : public ModularBackend, Common::EventSource {
 public:
 	OSystem_NULL();
 	virtual ~OSystem_NULL();
 
 	virtual void initBackend();
 
+	virtual Common::EventSource *getDefaultEventSource() { return this; }
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual void updateScreen();
+
 	virtual uint32 getMillis();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+	void printBenchmarkReport();
+
+private:
+	void advanceTime(uint msecs);
+
+	enum {
+		kSampleRate = 22050,
+		kMixBufferSamples = 1024
+	};
+
+	uint32 _millis;
+	uint32 _mixRemainder;
+	bool _inTimerHandler;
+	byte *_mixBuffer;
+
+	bool _benchmark;
+	bool _benchmarkQuit;
+	uint32 _frames;
 };
 
-OSystem_NULL::OSystem_NULL() {
+OSystem_NULL::OSystem_NULL() :
+	_millis(0), _mixRemainder(0), _inTimerHandler(false), _mixBuffer(0),
+	_benchmark(false), _benchmarkQuit(false), _frames(0) {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(POSIX)
@@ -69,6 +117,7 @@ OSystem_NULL::OSystem_NULL() {
 }
 
 OSystem_NULL::~OSystem_NULL() {
+	delete[] _mixBuffer;
 }
 
 void OSystem_NULL::initBackend() {
@@ -77,26 +126,85 @@ void OSystem_NULL::initBackend() {
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
 	_graphicsManager = new NullGraphicsManager();
-	_mixer = new Audio::MixerImpl(this, 22050);
+	_mixer = new Audio::MixerImpl(this, kSampleRate);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
+	// The mixer and the timers are driven by advanceTime()
+	_mixBuffer = new byte[kMixBufferSamples * 4];
+	((Audio::MixerImpl *)_mixer)->setReady(true);
 
-	// Note that both the mixer and the timer manager are useless
-	// this way; they need to be hooked into the system somehow to
-	// be functional. Of course, can't do that in a NULL backend :).
+	_benchmark = ConfMan.getBool("benchmark");
+	if (_benchmark && ConfMan.get("record_mode") != "playback")
+		warning("Benchmark mode should be used with --record-mode=playback");
 
 	ModularBackend::initBackend();
 }
 
 bool OSystem_NULL::pollEvent(Common::Event &event) {
+	// Let busy waiting engines see the time pass
+	advanceTime(1);
+
+	// Quit once the recorded events are used up
+	if (_benchmark && !_benchmarkQuit && g_eventRec.isPlaybackFinished()) {
+		_benchmarkQuit = true;
+		event.type = Common::EVENT_QUIT;
+		return true;
+	}
+
 	return false;
 }
 
+void OSystem_NULL::updateScreen() {
+	_frames++;
+	ModularBackend::updateScreen();
+}
+
 uint32 OSystem_NULL::getMillis() {
-	return 0;
+	uint32 millis = _millis;
+	g_eventRec.processMillis(millis);
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (!g_eventRec.processDelayMillis(msecs))
+		advanceTime(msecs);
+}
+
+void OSystem_NULL::advanceTime(uint msecs) {
+	_millis += msecs;
+
+	// Mix the sound for the time passed, and throw it away
+	uint32 samples = (msecs * kSampleRate + _mixRemainder) / 1000;
+	_mixRemainder = (msecs * kSampleRate + _mixRemainder) % 1000;
+	while (samples > 0) {
+		const uint32 len = MIN<uint32>(samples, kMixBufferSamples);
+		((Audio::MixerImpl *)_mixer)->mixCallback(_mixBuffer, len * 4);
+		samples -= len;
+	}
+
+	// The timer handler may call getMillis(), which can end up in here
+	// again during event recorder playback
+	if (!_inTimerHandler) {
+		_inTimerHandler = true;
+		((DefaultTimerManager *)_timerManager)->handler();
+		_inTimerHandler = false;
+	}
+}
+
+void OSystem_NULL::printBenchmarkReport() {
+	if (!_benchmark)
+		return;
+
+	printf("Benchmark: %u frames in %u ms of game time\n", _frames, _millis);
+#if defined(POSIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		const double cpuTime = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+		                       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+		printf("Benchmark: %.3f s CPU time, %.3f ms per frame\n", cpuTime,
+		       _frames ? cpuTime * 1000.0 / _frames : 0.0);
+		printf("Benchmark: %ld KB peak memory\n", (long)usage.ru_maxrss);
+	}
+#endif
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
@@ -121,6 +229,7 @@ int main(int argc, char *argv[]) {
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+	((OSystem_NULL *)g_system)->printBenchmarkReport();
 	delete (OSystem_NULL *)g_system;
 	return res;
 }
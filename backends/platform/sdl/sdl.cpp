@@ -74,8 +74,9 @@ OSystem_SDL::OSystem_SDL()
 	_initedSDL(false),
 	_logger(0),
 	_mixerManager(0),
-	_eventSource(0) {
-
+	_eventSource(0),
+	_lastFrameEnd(0),
+	_delayedSinceFrame(0) {
 }
 
 OSystem_SDL::~OSystem_SDL() {
@@ -131,6 +132,10 @@ void OSystem_SDL::init() {
 	if (_mutexManager == 0)
 		_mutexManager = new SdlMutexManager();
 
+	// The counters create their mutex on first use, so this has to wait
+	// for the mutex manager
+	_perfEngineTime = g_perfCounters.registerCounter("Engine ms", Common::PerfCounters::kAveragePerFrame);
+
 	if (_timerManager == 0)
 		_timerManager = new SdlTimerManager();
 
@@ -473,8 +478,24 @@ uint32 OSystem_SDL::getMillis() {
 }
 
 void OSystem_SDL::delayMillis(uint msecs) {
-	if (!g_eventRec.processDelayMillis(msecs))
+	if (!g_eventRec.processDelayMillis(msecs)) {
+		const uint32 start = SDL_GetTicks();
 		SDL_Delay(msecs);
+		_delayedSinceFrame += SDL_GetTicks() - start;
+	}
+}
+
+void OSystem_SDL::updateScreen() {
+	// Everything since the last frame, except for sleeping, was spent in
+	// the engine.
+	const uint32 now = SDL_GetTicks();
+	if (_lastFrameEnd != 0 && now - _lastFrameEnd > _delayedSinceFrame)
+		g_perfCounters.add(_perfEngineTime, now - _lastFrameEnd - _delayedSinceFrame);
+
+	ModularBackend::updateScreen();
+
+	_lastFrameEnd = SDL_GetTicks();
+	_delayedSinceFrame = 0;
 }
 
 void OSystem_SDL::getTimeAndDate(TimeDate &td) const {
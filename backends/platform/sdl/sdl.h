@@ -30,6 +30,8 @@
 #include "backends/events/sdl/sdl-events.h"
 #include "backends/log/log.h"
 
+#include "common/perfcounters.h"
+
 /**
  * Base OSystem class for all SDL ports.
  */
@@ -71,6 +73,7 @@ public:
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0);
 	virtual uint32 getMillis();
 	virtual void delayMillis(uint msecs);
+	virtual void updateScreen();
 	virtual void getTimeAndDate(TimeDate &td) const;
 	virtual Audio::Mixer *getMixer();
 
@@ -91,6 +94,13 @@ protected:
 
 	virtual Common::EventSource *getDefaultEventSource() { return _eventSource; }
 
+	/** Counter for the time the engine spent between two frames */
+	Common::PerfCounters::CounterId _perfEngineTime;
+	/** When the last frame was displayed */
+	uint32 _lastFrameEnd;
+	/** Time spent in delayMillis() since the last frame was displayed */
+	uint32 _delayedSinceFrame;
+
 	/**
 	 * Initialze the SDL library.
 	 */
@@ -358,6 +358,10 @@ bool EventRecorder::processDelayMillis(uint &msecs) {
 	return false;
 }
 
+bool EventRecorder::isPlaybackFinished() const {
+	return _recordMode == kRecorderPlayback && !_hasPlaybackEvent && _playbackCount >= _recordCount;
+}
+
 bool EventRecorder::notifyEvent(const Event &ev) {
 	if (_recordMode != kRecorderRecord)
 		return false;
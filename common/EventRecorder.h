@@ -59,6 +59,9 @@ public:
 	/** TODO: Add documentation, this is only used by the backend */
 	bool processDelayMillis(uint &msecs);
 
+	/** Returns true when all recorded events have been played back */
+	bool isPlaybackFinished() const;
+
 private:
 	bool notifyEvent(const Event &ev);
 	bool notifyPoll();
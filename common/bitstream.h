@@ -26,148 +26,183 @@
 #define COMMON_BITSTREAM_H
 
 #include "common/scummsys.h"
+#include "common/endian.h"
+#include "common/noncopyable.h"
+#include "common/stream.h"
+#include "common/textconsole.h"
 
 namespace Common {
 
-class SeekableReadStream;
-
 /**
  * A bit stream, giving access to data one bit at a time.
  *
+ * The data is copied into a buffer on construction, so reading, peeking
+ * and skipping bits never goes through a stream. All methods are inline
+ * and non-virtual; code which should work with several kinds of bit
+ * streams takes the bit stream type as a template parameter.
+ *
+ * Big-endian bit streams hand out the bits of each byte in the order of
+ * MSB to LSB, little-endian bit streams in the order of LSB to MSB. The
+ * data has to be a multiple of valueBits (8, 16 or 32) bits long.
+ *
+ * Like the original stream based readers, which fetched a whole value when
+ * they ran out of bits, the stream may be read up to one value past its end.
+ * These bits are 0; only reading beyond them is an error.
+ *
  * Used in engines:
  *  - scumm
  */
-class BitStream {
-public:
-	BitStream();
-	virtual ~BitStream();
-
-	/** Read a bit from the bitstream. */
-	virtual uint32 getBit() = 0;
-
-	/** Read a number of bits, creating a multi-bit value. */
-	virtual uint32 getBits(uint32 n) = 0;
-
-	/** Add more bits, creating a multi-bit value in stages. */
-	virtual void addBit(uint32 &x, uint32 n) = 0;
-
-	/** Skip a number of bits. */
-	void skip(uint32 n);
-
-	/** Get the current position, in bits. */
-	virtual uint32 pos()  const = 0;
-	/** Return the number of bits in the stream. */
-	virtual uint32 size() const = 0;
-};
-
-/**
- * A big-endian bit stream.
- *
- * The input data is read one byte at a time. Their bits are handed out
- * in the order of MSB to LSB. When all 8 bits of a byte have been consumed,
- * another input data byte is read.
- */
-class BitStreamBE : public BitStream {
+template<int valueBits, bool isLE>
+class BitStreamImpl : NonCopyable {
 public:
 	/**
-	 * Create a big endian bit stream.
+	 * Create a bit stream.
 	 *
 	 * Reads and copies bitCount bits from the provided stream.
 	 * Ownership of the stream is not transferred.
 	 */
-	BitStreamBE(SeekableReadStream &stream, uint32 bitCount);
+	BitStreamImpl(SeekableReadStream &stream, uint32 bitCount) : _pos(0), _size(bitCount) {
+		const uint32 byteSize = checkSize(bitCount);
+		if (stream.read(_data, byteSize) != byteSize) {
+			delete[] _data;
+			error("Bad BitStream size");
+		}
+	}
 
 	/**
-	 * Create a big endian bit stream.
+	 * Create a bit stream.
 	 *
 	 * Reads and copies bitCount bits from the provided data.
 	 * Ownership of the data is not transferred.
 	 */
-	BitStreamBE(const byte *data, uint32 bitCount);
-
-	~BitStreamBE();
-
-	uint32 getBit();
+	BitStreamImpl(const byte *data, uint32 bitCount) : _pos(0), _size(bitCount) {
+		memcpy(_data, data, checkSize(bitCount));
+	}
 
-	/**
-	 * Read a number of bits, creating a multi-bit value.
-	 *
-	 * The bits are read one at a time, in the order MSB to LSB and
-	 * or'd together to create a multi-bit value.
-	 */
-	uint32 getBits(uint32 n);
-
-	/**
-	 * Add more bits, creating a multi-bit value in stages.
-	 *
-	 * Shifts in n new bits into the value x, in the order of MSB to LSB.
-	 */
-	void addBit(uint32 &x, uint32 n);
+	~BitStreamImpl() {
+		delete[] _data;
+	}
 
-	uint32 pos()  const;
-	uint32 size() const;
+	/** Return true if the bits of a byte are handed out from MSB to LSB. */
+	static bool isMSB2LSB() { return !isLE; }
 
-private:
-	SeekableReadStream *_stream;
+	/** Read a bit from the bitstream. */
+	uint32 getBit() {
+		if (_pos >= _size + valueBits)
+			error("End of bit stream reached");
 
-	byte  _value;   ///< Current byte.
-	uint8 _inValue; ///< Position within the current byte.
-};
+		const byte value = _data[_pos >> 3];
+		const uint32 b = isLE ? ((value >> (_pos & 7)) & 1) : ((value >> (7 - (_pos & 7))) & 1);
+		_pos++;
 
-/**
- * A little-endian bit stream, reading 32bit values at a time.
- *
- * The input data is read one little-endian uint32 at a time. Their bits are
- * handed out in the order of LSB to MSB. When all 8 bits of a byte have been
- * consumed, another little-endian input data uint32 is read.
- */
-class BitStream32LE : public BitStream {
-public:
-	/**
-	 * Create a little-endian bit stream.
-	 *
-	 * Reads and copies bitCount bits from the provided stream.
-	 * Ownership of the stream is not transferred.
-	 */
-	BitStream32LE(SeekableReadStream &stream, uint32 bitCount);
+		return b;
+	}
 
 	/**
-	 * Create a little-endian bit stream.
+	 * Read a number of bits, creating a multi-bit value.
 	 *
-	 * Reads and copies bitCount bits from the provided data.
-	 * Ownership of the data is not transferred.
+	 * The first bit read ends up in the MSB of the value for big-endian
+	 * bit streams, and in the LSB for little-endian bit streams.
 	 */
-	BitStream32LE(const byte *data, uint32 bitCount);
+	uint32 getBits(uint32 n) {
+		if (n > 32)
+			error("Too many bits requested to be read");
+		if (_pos + n > _size + valueBits)
+			error("End of bit stream reached");
 
-	~BitStream32LE();
+		const uint32 v = peekBits(n);
+		_pos += n;
 
-	uint32 getBit();
+		return v;
+	}
 
 	/**
-	 * Read a number of bits, creating a multi-bit value.
-	 *
-	 * The bits are read one at a time, in the order LSB to MSB and
-	 * or'd together to create a multi-bit value.
+	 * Return the next n bits, like getBits(), without consuming them.
+	 * Bits after the end of the stream read as 0.
 	 */
-	uint32 getBits(uint32 n);
+	uint32 peekBits(uint32 n) const {
+		assert(n <= 32);
+		if (n == 0)
+			return 0;
+
+		// The buffer is padded, so this may read a few bytes past the end
+		const byte *p = _data + (_pos >> 3);
+		const uint32 shift = _pos & 7;
+
+		if (isLE) {
+			uint32 v = READ_LE_UINT32(p) >> shift;
+			if (shift)
+				v |= (uint32)p[4] << (32 - shift);
+			return (n == 32) ? v : (v & ((1U << n) - 1));
+		} else {
+			uint32 v = READ_BE_UINT32(p) << shift;
+			if (shift)
+				v |= p[4] >> (8 - shift);
+			return v >> (32 - n);
+		}
+	}
 
 	/**
 	 * Add more bits, creating a multi-bit value in stages.
 	 *
-	 * Shifts in n new bits into the value x, in the order of LSB to MSB.
+	 * Big-endian bit streams shift the new bit into the value from the
+	 * right, little-endian bit streams put it at bit position n.
 	 */
-	void addBit(uint32 &x, uint32 n);
+	void addBit(uint32 &x, uint32 n) {
+		if (isLE)
+			x = (x & ~(1 << n)) | (getBit() << n);
+		else
+			x = (x << 1) | getBit();
+	}
 
-	uint32 pos()  const;
-	uint32 size() const;
+	/** Skip a number of bits. */
+	void skip(uint32 n) {
+		if (_pos + n > _size + valueBits)
+			error("End of bit stream reached");
 
-private:
-	SeekableReadStream *_stream;
+		_pos += n;
+	}
+
+	/** Get the current position, in bits. */
+	uint32 pos() const { return _pos; }
+	/** Return the number of bits in the stream. */
+	uint32 size() const { return _size; }
 
-	uint32 _value;   ///< Current 32bit value.
-	uint8  _inValue; ///< Position within the current 32bit value.
+private:
+	enum {
+		/**
+		 * Zero bytes after the data, so peekBits() needs no bounds checks,
+		 * even when reading the value past the end of the data.
+		 */
+		kPadding = valueBits / 8 + 8
+	};
+
+	byte *_data;
+	uint32 _pos;  ///< Current position, in bits.
+	uint32 _size; ///< Size of the data, in bits.
+
+	/** Check the size of the data and allocate the buffer for it. */
+	uint32 checkSize(uint32 bitCount) {
+		if ((bitCount % valueBits) != 0)
+			error("Bit stream size has to be divisible by %d", valueBits);
+
+		const uint32 byteSize = bitCount / 8;
+		_data = new byte[byteSize + kPadding];
+		memset(_data + byteSize, 0, kPadding);
+
+		return byteSize;
+	}
 };
 
+/** A big-endian bit stream, reading 8bit values at a time. */
+typedef BitStreamImpl<8, false> BitStreamBE;
+/** A big-endian bit stream, reading 32bit values at a time. */
+typedef BitStreamImpl<32, false> BitStream32BE;
+/** A little-endian bit stream, reading 8bit values at a time. */
+typedef BitStreamImpl<8, true> BitStreamLE;
+/** A little-endian bit stream, reading 32bit values at a time. */
+typedef BitStreamImpl<32, true> BitStream32LE;
+
 } // End of namespace Common
 
 #endif // COMMON_BITSTREAM_H
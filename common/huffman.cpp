@@ -25,7 +25,6 @@
 #include "common/huffman.h"
 #include "common/util.h"
 #include "common/textconsole.h"
-#include "common/bitstream.h"
 
 namespace Common {
 
@@ -58,6 +57,9 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 		// And put the pointer to the symbol/code struct into the symbol list.
 		_symbols[i] = &_codes[lengths[i] - 1].back();
 	}
+
+	_prefixBits = MIN<uint32>(maxLength, kPrefixBitsMax);
+	buildPrefixTables();
 }
 
 Huffman::~Huffman() {
@@ -66,21 +68,53 @@ Huffman::~Huffman() {
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (uint32 i = 0; i < _symbols.size(); i++)
 		_symbols[i]->symbol = symbols ? *symbols++ : i;
-}
-
-uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
 
-	for (uint32 i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	buildPrefixTables();
+}
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+void Huffman::buildPrefixTables() {
+	const uint32 tableSize = 1 << _prefixBits;
+
+	PrefixEntry empty;
+	empty.symbol = 0;
+	empty.length = 0;
+
+	_prefixMSB.resize(tableSize);
+	_prefixLSB.resize(tableSize);
+	for (uint32 i = 0; i < tableSize; i++)
+		_prefixMSB[i] = _prefixLSB[i] = empty;
+
+	// Codes are matched by increasing length, and in list order within a
+	// length. Fill the tables in the opposite order, so that the same code
+	// wins if the codes are not prefix free.
+	for (int length = _prefixBits; length > 0; length--) {
+		const CodeList &codes = _codes[length - 1];
+		const uint32 fill = 1 << (_prefixBits - length);
+
+		Array<const Symbol *> reversed;
+		for (CodeList::const_iterator cCode = codes.begin(); cCode != codes.end(); ++cCode)
+			if ((cCode->code >> length) == 0)	// Codes with more bits never match
+				reversed.push_back(&*cCode);
+
+		for (int i = reversed.size() - 1; i >= 0; i--) {
+			PrefixEntry entry;
+			entry.symbol = reversed[i]->symbol;
+			entry.length = length;
+
+			// MSB to LSB: The code is at the top of the index
+			const uint32 codeMSB = reversed[i]->code << (_prefixBits - length);
+			for (uint32 j = 0; j < fill; j++)
+				_prefixMSB[codeMSB | j] = entry;
+
+			// LSB to MSB: The code is at the bottom of the index
+			for (uint32 j = 0; j < fill; j++)
+				_prefixLSB[reversed[i]->code | (j << length)] = entry;
+		}
 	}
+}
 
+void Huffman::unknownCode() const {
 	error("Unknown Huffman code");
-	return 0;
 }
 
 } // End of namespace Common
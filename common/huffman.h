@@ -31,11 +31,14 @@
 
 namespace Common {
 
-class BitStream;
-
 /**
  * Huffman bitstream decoding
  *
+ * Codes of up to kPrefixBitsMax bits are decoded with one lookup into a
+ * table, indexed by the next bits of the stream. There is such a table for
+ * each bit order, see BitStreamImpl::isMSB2LSB(). Longer codes are looked
+ * up in lists of the codes by length.
+ *
  * Used in engines:
  *  - scumm
  */
@@ -56,9 +59,38 @@ public:
 	void setSymbols(const uint32 *symbols = 0);
 
 	/** Return the next symbol in the bitstream. */
-	uint32 getSymbol(BitStream &bits) const;
+	template<class BITSTREAM>
+	uint32 getSymbol(BITSTREAM &bits) const {
+		const PrefixTable &table = BITSTREAM::isMSB2LSB() ? _prefixMSB : _prefixLSB;
+		const PrefixEntry &entry = table[bits.peekBits(_prefixBits)];
+
+		if (entry.length) {
+			bits.skip(entry.length);
+			return entry.symbol;
+		}
+
+		// A code longer than the prefix table, or an invalid one
+		for (uint32 i = _prefixBits; i < _codes.size(); i++) {
+			const uint32 code = bits.peekBits(i + 1);
+
+			for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode) {
+				if (code == cCode->code) {
+					bits.skip(i + 1);
+					return cCode->symbol;
+				}
+			}
+		}
+
+		unknownCode();
+		return 0;
+	}
 
 private:
+	enum {
+		/** Maximal number of bits used to index the prefix tables */
+		kPrefixBitsMax = 10
+	};
+
 	struct Symbol {
 		uint32 code;
 		uint32 symbol;
@@ -70,11 +102,27 @@ private:
 	typedef Array<CodeList> CodeLists;
 	typedef Array<Symbol*> SymbolList;
 
+	struct PrefixEntry {
+		uint32 symbol;
+		uint8 length; ///< Length of the code, or 0 if there is none.
+	};
+
+	typedef Array<PrefixEntry> PrefixTable;
+
 	/** Lists of codes and their symbols, sorted by code length. */
 	CodeLists _codes;
 
 	/** Sorted list of pointers to the symbols. */
 	SymbolList _symbols;
+
+	/** Number of bits used to index the prefix tables. */
+	uint32 _prefixBits;
+
+	/** Prefix tables for MSB to LSB and for LSB to MSB bit streams. */
+	PrefixTable _prefixMSB, _prefixLSB;
+
+	void buildPrefixTables();
+	void unknownCode() const;
 };
 
 } // End of namespace Common
@@ -12,12 +12,14 @@ MODULE_OBJS := \
 	file.o \
 	fs.o \
 	hashmap.o \
+	huffman.o \
 	iff_container.o \
 	localization.o \
 	macresman.o \
 	memorypool.o \
 	md5.o \
 	mutex.o \
+	perfcounters.o \
 	quicktime.o \
 	random.o \
 	rational.o \
@@ -38,11 +40,9 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bitstream.o \
 	cosinetables.o \
 	dct.o \
 	fft.o \
-	huffman.o \
 	rdft.o \
 	sinetables.o
 endif
@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/perfcounters.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(PerfCounters);
+
+namespace {
+
+/** Auxillary class to (un)lock a mutex on the stack, if there is one. */
+class CounterLock {
+public:
+	explicit CounterLock(Mutex *mutex) : _mutex(mutex) {
+		if (_mutex)
+			_mutex->lock();
+	}
+	~CounterLock() {
+		if (_mutex)
+			_mutex->unlock();
+	}
+
+private:
+	Mutex *_mutex;
+};
+
+} // End of anonymous namespace
+
+PerfCounters::PerfCounters()
+	: _mutex(0), _enabled(false), _started(false), _periodStart(0), _frames(0), _frameRate(0) {
+	if (g_system)
+		_mutex = new Mutex();
+	_counters.reserve(kMaxCounters);
+}
+
+PerfCounters::~PerfCounters() {
+	delete _mutex;
+}
+
+void PerfCounters::addValue(CounterId id, uint32 value) {
+	CounterLock lock(_mutex);
+	_counters[id].current += value;
+}
+
+PerfCounters::CounterId PerfCounters::registerCounter(const String &name, Mode mode) {
+	CounterLock lock(_mutex);
+
+	for (uint i = 0; i < _counters.size(); ++i) {
+		if (_counters[i].name == name)
+			return i;
+	}
+
+	assert(_counters.size() < kMaxCounters);
+
+	Counter counter;
+	counter.name = name;
+	counter.mode = mode;
+	counter.current = 0;
+	counter.published = 0;
+	_counters.push_back(counter);
+	return _counters.size() - 1;
+}
+
+void PerfCounters::setEnabled(bool enable) {
+	if (enable == _enabled)
+		return;
+
+	CounterLock lock(_mutex);
+	for (uint i = 0; i < _counters.size(); ++i) {
+		_counters[i].current = 0;
+		_counters[i].published = 0;
+	}
+	_frames = 0;
+	_frameRate = 0;
+	_started = false;
+	_enabled = enable;
+}
+
+bool PerfCounters::frameDone(uint32 millis) {
+	if (!_enabled)
+		return false;
+
+	// The first period starts with the first frame after enabling
+	if (!_started) {
+		_started = true;
+		_periodStart = millis;
+		return false;
+	}
+
+	_frames++;
+
+	const uint32 elapsed = millis - _periodStart;
+	if (elapsed < 1000)
+		return false;
+
+	CounterLock lock(_mutex);
+	for (uint i = 0; i < _counters.size(); ++i) {
+		Counter &counter = _counters[i];
+		if (counter.mode == kAveragePerFrame)
+			counter.published = (float)counter.current / _frames;
+		else
+			counter.published = counter.current * 1000.0f / elapsed;
+		counter.current = 0;
+	}
+
+	_frameRate = _frames * 1000.0f / elapsed;
+	_frames = 0;
+	_periodStart = millis;
+	return true;
+}
+
+} // End of namespace Common
@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_PERFCOUNTERS_H
+#define COMMON_PERFCOUNTERS_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+#define g_perfCounters (Common::PerfCounters::instance())
+
+namespace Common {
+
+/**
+ * Performance counters, which engines and backends can use to publish
+ * timings and statistics, e.g. for the performance overlay of the SDL
+ * backend.
+ *
+ * The counters are summed up for about a second, and then published
+ * either as the average per displayed frame or as the total per second.
+ * Counting is disabled by default, so add() is almost free then.
+ *
+ * add() may be called from other threads, like the audio callback, so the
+ * current values are guarded by a mutex. Room for kMaxCounters counters is
+ * reserved up front, so registering a counter doesn't move the others while
+ * those threads are running.
+ */
+class PerfCounters : public Singleton<PerfCounters> {
+public:
+	enum Mode {
+		/** Published as average per frame, e.g. for the time spent on something */
+		kAveragePerFrame,
+		/** Published as total per second, e.g. for events */
+		kTotalPerSecond
+	};
+
+	typedef uint CounterId;
+
+	enum {
+		kMaxCounters = 32
+	};
+
+	/**
+	 * Register a counter. If there already is a counter with the same
+	 * name, that one is returned.
+	 */
+	CounterId registerCounter(const String &name, Mode mode);
+
+	void setEnabled(bool enable);
+	bool isEnabled() const { return _enabled; }
+
+	/** Add to a counter. Does nothing while counting is disabled. */
+	void add(CounterId id, uint32 value) {
+		if (_enabled)
+			addValue(id, value);
+	}
+
+	/**
+	 * Tell the counters that a frame was displayed. Once a second, the
+	 * current values are published and reset.
+	 *
+	 * @param millis	the current time in milliseconds
+	 * @return true if new values were published
+	 */
+	bool frameDone(uint32 millis);
+
+	uint getNumCounters() const { return _counters.size(); }
+	const String &getName(CounterId id) const { return _counters[id].name; }
+
+	/** Get the last published value of a counter. */
+	float getValue(CounterId id) const { return _counters[id].published; }
+
+	/** Get the number of frames displayed during the last second. */
+	float getFrameRate() const { return _frameRate; }
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	PerfCounters();
+	~PerfCounters();
+
+	struct Counter {
+		String name;
+		Mode mode;
+		uint32 current;
+		float published;
+	};
+
+	void addValue(CounterId id, uint32 value);
+
+	/**
+	 * Guards the current values. It needs an OSystem, so it is only
+	 * created if g_system is set up, which is not the case for the tests.
+	 */
+	Mutex *_mutex;
+
+	Array<Counter> _counters;
+	bool _enabled;
+	bool _started;
+	uint32 _periodStart;
+	uint32 _frames;
+	float _frameRate;
+};
+
+} // End of namespace Common
+
+#endif
@@ -126,6 +126,160 @@ void QuickTimeParser::init() {
 	for (uint32 i = 0; i < _tracks.size(); i++)
 		if (!_tracks[i]->timeScale)
 			_tracks[i]->timeScale = _timeScale;
+
+	for (uint32 i = 0; i < _tracks.size(); i++)
+		initSampleIndex(_tracks[i]);
+}
+
+void QuickTimeParser::initSampleIndex(Track *track) {
+	// Cumulative sample numbers and times of the time-to-sample entries
+	uint32 sample = 0;
+	uint32 time = 0;
+	for (int32 i = 0; i < track->timeToSampleCount; i++) {
+		track->timeToSample[i].firstSample = sample;
+		track->timeToSample[i].startTime = time;
+
+		sample += track->timeToSample[i].count;
+		time += track->timeToSample[i].count * track->timeToSample[i].duration;
+	}
+
+	// The first sample of each chunk
+	delete[] track->chunkFirstSamples;
+	track->chunkFirstSamples = new uint32[track->chunkCount];
+
+	sample = 0;
+	uint32 sampleToChunkIndex = 0;
+	for (uint32 i = 0; i < track->chunkCount; i++) {
+		while (sampleToChunkIndex + 1 < track->sampleToChunkCount && i >= track->sampleToChunk[sampleToChunkIndex + 1].first)
+			sampleToChunkIndex++;
+
+		track->chunkFirstSamples[i] = sample;
+
+		if (track->sampleToChunkCount && i >= track->sampleToChunk[sampleToChunkIndex].first)
+			sample += track->sampleToChunk[sampleToChunkIndex].count;
+	}
+}
+
+uint32 QuickTimeParser::getSampleTime(const Track *track, uint32 sample) const {
+	// Find the last entry starting at or before the sample
+	int32 low = 0, high = track->timeToSampleCount - 1;
+	if (high < 0)
+		return 0;
+
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->timeToSample[mid].firstSample <= sample)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	const TimeToSampleEntry &entry = track->timeToSample[low];
+	return entry.startTime + (sample - entry.firstSample) * entry.duration;
+}
+
+uint32 QuickTimeParser::getSampleDuration(const Track *track, uint32 sample) const {
+	int32 low = 0, high = track->timeToSampleCount - 1;
+	if (high < 0 || sample >= track->frameCount)
+		return 0;
+
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->timeToSample[mid].firstSample <= sample)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	return track->timeToSample[low].duration;
+}
+
+uint32 QuickTimeParser::findSampleAtTime(const Track *track, uint32 time) const {
+	// Find the last entry starting at or before the time
+	int32 low = 0, high = track->timeToSampleCount - 1;
+	if (high < 0)
+		return 0;
+
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->timeToSample[mid].startTime <= time)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	const TimeToSampleEntry &entry = track->timeToSample[low];
+	uint32 sample = entry.firstSample;
+	if (entry.duration > 0)
+		sample += MIN<uint32>((time - entry.startTime) / entry.duration, entry.count);
+	else
+		sample += entry.count;
+
+	return MIN(sample, track->frameCount);
+}
+
+uint32 QuickTimeParser::findKeyFrame(const Track *track, uint32 sample) const {
+	// The key frames are sorted, so find the last one at or before the sample
+	int32 low = 0, high = track->keyframeCount - 1;
+	if (high < 0 || track->keyframes[0] > sample) {
+		// If none found, we'll assume the requested frame is a key frame
+		return sample;
+	}
+
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->keyframes[mid] <= sample)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	return track->keyframes[low];
+}
+
+bool QuickTimeParser::findSampleOffset(const Track *track, uint32 sample, uint32 &offset, uint32 &descId) const {
+	// Find the last chunk starting at or before the sample
+	int32 low = 0, high = track->chunkCount - 1;
+	if (high < 0 || !track->sampleToChunkCount || sample >= track->sampleCount)
+		return false;
+
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->chunkFirstSamples[mid] <= sample)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	uint32 chunk = low;
+
+	// Find the sample-to-chunk entry of the chunk
+	low = 0;
+	high = track->sampleToChunkCount - 1;
+	while (low < high) {
+		int32 mid = (low + high + 1) / 2;
+		if (track->sampleToChunk[mid].first <= chunk)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+
+	const SampleToChunkEntry &entry = track->sampleToChunk[low];
+	if (chunk < entry.first || sample >= track->chunkFirstSamples[chunk] + entry.count)
+		return false;
+
+	descId = entry.id;
+	offset = track->chunkOffsets[chunk];
+
+	// If the chunk holds more than one sample, skip the ones before ours
+	if (track->sampleSize != 0) {
+		offset += (sample - track->chunkFirstSamples[chunk]) * track->sampleSize;
+	} else {
+		for (uint32 i = track->chunkFirstSamples[chunk]; i < sample; i++)
+			offset += track->sampleSizes[i];
+	}
+
+	return true;
 }
 
 void QuickTimeParser::initParseTable() {
@@ -773,6 +927,7 @@ QuickTimeParser::SampleDesc::SampleDesc(Track *parentTrack, uint32 codecTag) {
 QuickTimeParser::Track::Track() {
 	chunkCount = 0;
 	chunkOffsets = 0;
+	chunkFirstSamples = 0;
 	timeToSampleCount = 0;
 	timeToSample = 0;
 	sampleToChunkCount = 0;
@@ -797,6 +952,7 @@ QuickTimeParser::Track::Track() {
 
 QuickTimeParser::Track::~Track() {
 	delete[] chunkOffsets;
+	delete[] chunkFirstSamples;
 	delete[] timeToSample;
 	delete[] sampleToChunk;
 	delete[] sampleSizes;
@@ -99,6 +99,10 @@ protected:
 	struct TimeToSampleEntry {
 		int count;
 		int duration;
+
+		// Filled in by init(), for lookups in O(log n)
+		uint32 firstSample;
+		uint32 startTime;
 	};
 
 	struct SampleToChunkEntry {
@@ -139,6 +143,7 @@ protected:
 
 		uint32 chunkCount;
 		uint32 *chunkOffsets;
+		uint32 *chunkFirstSamples; // filled in by init()
 		int timeToSampleCount;
 		TimeToSampleEntry *timeToSample;
 		uint32 sampleToChunkCount;
@@ -184,6 +189,30 @@ protected:
 
 	void initParseTable();
 	void init();
+	void initSampleIndex(Track *track);
+
+	/** Get the time a sample starts at, in the time scale of the track. */
+	uint32 getSampleTime(const Track *track, uint32 sample) const;
+
+	/** Get the duration of a sample, in the time scale of the track. */
+	uint32 getSampleDuration(const Track *track, uint32 sample) const;
+
+	/**
+	 * Find the sample shown at a time, in the time scale of the track.
+	 * If the time is past the end of the track, the sample count is returned.
+	 */
+	uint32 findSampleAtTime(const Track *track, uint32 time) const;
+
+	/** Find the last key frame at or before a sample. */
+	uint32 findKeyFrame(const Track *track, uint32 sample) const;
+
+	/**
+	 * Find where a sample is stored in the file.
+	 * @param offset	the offset of the sample in the file
+	 * @param descId	the id of the sample description of the sample
+	 * @return false if the sample isn't in any chunk
+	 */
+	bool findSampleOffset(const Track *track, uint32 sample, uint32 &offset, uint32 &descId) const;
 
 	int readDefault(Atom atom);
 	int readLeaf(Atom atom);
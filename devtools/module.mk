@@ -16,7 +16,7 @@ DEVTOOLS := \
 
 include $(srcdir)/devtools/*/module.mk
 
-.PHONY: $(srcdir)/devtools/*/module.mk
+.PHONY: $(srcdir)/devtools/*/module.mk clean-benchmarks
 
 # Make sure the 'all' / 'clean' targets build/clean the devtools, too
 #all:
@@ -44,6 +44,21 @@ devtools/make-scumm-fontdata$(EXEEXT): $(srcdir)/devtools/make-scumm-fontdata.c
 	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
 	$(QUIET_LINK)$(LD) $(CFLAGS) -Wall -o $@ $<
 
+# The benchmarks need the libraries of the configured build tree, so they
+# are not part of the 'devtools' target.
+devtools/scaler-bench$(EXEEXT): $(srcdir)/devtools/scaler-bench.cpp graphics/libgraphics.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(CXX) $(CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(LIBS)
+
+devtools/video-bench$(EXEEXT): $(srcdir)/devtools/video-bench.cpp video/libvideo.a audio/libaudio.a graphics/libgraphics.a backends/libbackends.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(CXX) $(CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(LIBS)
+
+clean-devtools: clean-benchmarks
+clean-benchmarks:
+	-$(RM) devtools/scaler-bench$(EXEEXT)
+	-$(RM) devtools/video-bench$(EXEEXT)
+
 #
 # Rules to explicitly rebuild the credits / MD5 tables.
 # The rules for the files in the "web" resp. "docs" modules
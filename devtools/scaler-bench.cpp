@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Small benchmark for the graphics scalers. It has to be linked against the
+// graphics and common libraries of a configured build tree, use
+// "make devtools/scaler-bench" to build it.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+#include "graphics/pixelformat.h"
+#include "graphics/scaler.h"
+#include "graphics/scaler/intern.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+	kWidth = 320,
+	kHeight = 200,
+	// The scalers look at the pixels around the rect, so leave a border
+	kSrcPitch = (kWidth + 4) * 2,
+	kDstPitch = kWidth * 3 * 2
+};
+
+#ifdef USE_HQ_SCALERS
+/**
+ * Check convertToYUV() against the formula used by the original
+ * RGBtoYUV lookup table, for every 16 bit color.
+ */
+template<typename ColorMask>
+static int checkYUV(const Graphics::PixelFormat &format) {
+	int errors = 0;
+	for (int color = 0; color < 65536; ++color) {
+		uint8 r, g, b;
+		format.colorToRGB(color, r, g, b);
+		const int Y = (r + g + b) >> 2;
+		const int u = 128 + ((r - b) >> 2);
+		const int v = 128 + ((-r + 2 * g - b) >> 3);
+		if (convertToYUV<ColorMask>(color) != ((Y << 16) | (u << 8) | v))
+			errors++;
+	}
+	return errors;
+}
+#endif
+
+/**
+ * Fill the source with something resembling game graphics: flat areas,
+ * gradients and some noise, so the edge detecting scalers take all paths.
+ */
+static void fillSource(uint16 *src) {
+	for (int y = 0; y < kHeight + 4; ++y) {
+		for (int x = 0; x < kWidth + 4; ++x) {
+			uint16 color;
+			if (y < kHeight / 3)
+				color = ((x / 16) * 0x0841) ^ ((y / 8) * 0x1000);
+			else if (y < 2 * kHeight / 3)
+				color = (x * 0x20 + y) & 0xFFFF;
+			else
+				color = rand() & 0xFFFF;
+			src[y * (kWidth + 4) + x] = color;
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	const int frames = (argc > 1) ? atoi(argv[1]) : 100;
+
+	uint16 *src = (uint16 *)malloc(kSrcPitch * (kHeight + 4));
+	uint8 *dst = (uint8 *)malloc(kDstPitch * kHeight * 3);
+	if (!src || !dst) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	fillSource(src);
+	const uint8 *srcPtr = (const uint8 *)src + kSrcPitch + 2;
+
+#ifdef USE_HQ_SCALERS
+	int yuvErrors = checkYUV<Graphics::ColorMasks<565> >(Graphics::createPixelFormat<565>());
+	yuvErrors += checkYUV<Graphics::ColorMasks<555> >(Graphics::createPixelFormat<555>());
+	printf("YUV conversion: %s\n", yuvErrors ? "MISMATCH" : "ok");
+#endif
+
+	printf("%d frames of %dx%d, 565\n", frames, kWidth, kHeight);
+	printf("  (* marks the implementations picked for this CPU)\n");
+	InitScalers(565);
+
+	const uint32 cpuFeatures = getScalerCPUFeatures();
+	for (const ScalerInfo *info = getScalerImplementations(); info->name; ++info) {
+		if (info->cpuFeatures & ~cpuFeatures) {
+			printf("  %-12s %-14s not supported by this CPU\n", info->name, info->implementation);
+			continue;
+		}
+
+		const clock_t start = clock();
+		for (int i = 0; i < frames; ++i)
+			info->proc(srcPtr, kSrcPitch, dst, kDstPitch, kWidth, kHeight);
+		const clock_t end = clock();
+
+		const double ms = (end - start) * 1000.0 / CLOCKS_PER_SEC;
+		const double mpixels = (double)kWidth * kHeight * frames / 1000000.0;
+		printf("%c %-12s %-14s %8.3f ms/frame %8.1f Mpixel/s\n",
+			findScaler(info->name) == info ? '*' : ' ',
+			info->name, info->implementation, ms / frames,
+			ms > 0 ? mpixels * 1000.0 / ms : 0.0);
+	}
+
+	DestroyScalers();
+	free(src);
+	free(dst);
+	return 0;
+}
@@ -0,0 +1,360 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Small benchmark for the video decoders. It decodes video files as fast as
+// possible, without any display or sound output. It has to be linked against
+// the libraries of a configured build tree, use "make devtools/video-bench"
+// to build it.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "audio/mixer_intern.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+#include "video/avi_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+#ifdef USE_BINK
+#include "video/bink_decoder.h"
+#endif
+// The Coktel decoders are only built along with an engine using them
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+#define VIDEO_BENCH_COKTEL
+#include "video/coktel_decoder.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Number of calls to the global operator new. Allocations done with malloc()
+ * directly, e.g. the pixels of Graphics::Surface, are not counted.
+ */
+static uint32 s_allocations = 0;
+
+void *operator new(size_t size) {
+	s_allocations++;
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void *operator new[](size_t size) {
+	s_allocations++;
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void operator delete(void *ptr) throw() {
+	free(ptr);
+}
+
+void operator delete[](void *ptr) throw() {
+	free(ptr);
+}
+
+static uint32 getCPUMillis() {
+	return (uint32)(clock() / (CLOCKS_PER_SEC / 1000));
+}
+
+/**
+ * A backend without any output, which provides just what the video decoders
+ * need: a clock, a screen format for the true color codecs and a mixer. The
+ * mixer is never run, so queued audio is decoded but not played.
+ */
+class BenchSystem : public OSystem {
+public:
+	BenchSystem() : _mixer(0) {}
+	~BenchSystem() { delete _mixer; }
+
+	void initBackend() {
+		// The mixer creates a mutex, so it needs g_system to be set up
+		_mixer = new Audio::MixerImpl(this, 22050);
+		_mixer->setReady(true);
+	}
+
+	const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode modes[] = { { 0, 0, 0 } };
+		return modes;
+	}
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return true; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> list;
+		list.push_back(getScreenFormat());
+		return list;
+	}
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	int16 getHeight() { return 480; }
+	int16 getWidth() { return 640; }
+	PaletteManager *getPaletteManager() { return 0; }
+	void copyRectToScreen(const byte *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return getScreenFormat(); }
+	void clearOverlay() {}
+	void grabOverlay(OverlayColor *buf, int pitch) {}
+	void copyRectToOverlay(const OverlayColor *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 480; }
+	int16 getOverlayWidth() { return 640; }
+
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const byte *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, int cursorTargetScale, const Graphics::PixelFormat *format) {}
+
+	uint32 getMillis() { return getCPUMillis(); }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+
+	// Everything runs on a single thread
+	MutexRef createMutex() { return (MutexRef)this; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+
+	Audio::Mixer *getMixer() { return _mixer; }
+
+	void quit() { exit(0); }
+	void displayMessageOnOSD(const char *msg) {}
+	void logMessage(LogMessageType::Type type, const char *message) {
+		fputs(message, stderr);
+	}
+
+private:
+	Audio::MixerImpl *_mixer;
+};
+
+#ifdef VIDEO_BENCH_COKTEL
+/**
+ * Create a Coktel decoder for the given file, based on its extension. They
+ * need some extra setup, so they are created apart from the others.
+ */
+static Video::CoktelDecoder *createCoktelDecoder(const Common::String &fileName, Audio::Mixer *mixer) {
+	Common::String name = fileName;
+	name.toLowercase();
+
+	if (name.hasSuffix(".imd"))
+		return new Video::IMDDecoder(mixer);
+	if (name.hasSuffix(".vmd"))
+		return new Video::VMDDecoder(mixer);
+
+	return 0;
+}
+#endif
+
+/** Create a decoder for the given file, based on its extension. */
+static Video::VideoDecoder *createDecoder(const Common::String &fileName, Audio::Mixer *mixer) {
+	Common::String name = fileName;
+	name.toLowercase();
+
+	if (name.hasSuffix(".avi"))
+		return new Video::AviDecoder(mixer);
+#ifdef USE_BINK
+	if (name.hasSuffix(".bik"))
+		return new Video::BinkDecoder();
+#endif
+	if (name.hasSuffix(".dxa"))
+		return new Video::DXADecoder();
+	if (name.hasSuffix(".fli") || name.hasSuffix(".flc"))
+		return new Video::FlicDecoder();
+	if (name.hasSuffix(".mov") || name.hasSuffix(".qt"))
+		return new Video::QuickTimeDecoder();
+	if (name.hasSuffix(".smk"))
+		return new Video::SmackerDecoder(mixer);
+
+	return 0;
+}
+
+/**
+ * Read a whole file into memory, so the benchmark doesn't depend on the
+ * speed of the disk.
+ */
+static Common::SeekableReadStream *readFile(const char *fileName) {
+	FILE *file = fopen(fileName, "rb");
+	if (!file)
+		return 0;
+
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	byte *data = (byte *)malloc(size > 0 ? size : 1);
+	if (!data || fread(data, 1, size, file) != (size_t)size) {
+		free(data);
+		fclose(file);
+		return 0;
+	}
+
+	fclose(file);
+	return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+}
+
+/** FNV-1a hash, as checksum over the decoded frames. */
+static uint32 hashData(uint32 hash, const byte *data, uint32 size) {
+	while (size--)
+		hash = (hash ^ *data++) * 16777619;
+	return hash;
+}
+
+static uint32 hashSurface(uint32 hash, const Graphics::Surface &surface) {
+	const byte *row = (const byte *)surface.pixels;
+	for (int y = 0; y < surface.h; ++y, row += surface.pitch)
+		hash = hashData(hash, row, surface.w * surface.format.bytesPerPixel);
+	return hash;
+}
+
+struct Result {
+	uint32 frames;
+	double totalTime;
+};
+
+static bool benchmarkFile(const char *fileName, int runs, Audio::Mixer *mixer, Result &total) {
+	uint32 checksum = 2166136261u;
+	uint32 frames = 0;
+	uint32 allocations = 0;
+	uint32 worstFrame = 0;
+	double totalTime = 0.0;
+	double worstTime = 0.0;
+
+	for (int run = 0; run < runs; ++run) {
+#ifdef VIDEO_BENCH_COKTEL
+		Video::CoktelDecoder *coktelDecoder = createCoktelDecoder(fileName, mixer);
+		Video::VideoDecoder *decoder = coktelDecoder;
+		if (!decoder)
+			decoder = createDecoder(fileName, mixer);
+#else
+		Video::VideoDecoder *decoder = createDecoder(fileName, mixer);
+#endif
+		if (!decoder) {
+			fprintf(stderr, "%s: Unknown video format\n", fileName);
+			return false;
+		}
+
+		Common::SeekableReadStream *stream = readFile(fileName);
+		if (!stream) {
+			fprintf(stderr, "%s: Can't read the file\n", fileName);
+			delete decoder;
+			return false;
+		}
+
+		if (!decoder->loadStream(stream)) {
+			fprintf(stderr, "%s: Can't load the video\n", fileName);
+			delete decoder;
+			return false;
+		}
+
+		if (run == 0)
+			printf("%s: %dx%d, %d bpp, %d frames\n", fileName, decoder->getWidth(), decoder->getHeight(),
+				decoder->getPixelFormat().bytesPerPixel * 8, decoder->getFrameCount());
+
+#ifdef VIDEO_BENCH_COKTEL
+		// Let the Coktel decoders draw into their own surface, like the
+		// Gob engine does when no sprite is given
+		if (coktelDecoder)
+			coktelDecoder->setXY(0, 0);
+#endif
+
+		for (uint32 frame = 0; !decoder->endOfVideo(); ++frame) {
+			const uint32 allocationsBefore = s_allocations;
+			const clock_t start = clock();
+			const Graphics::Surface *surface = decoder->decodeNextFrame();
+			const clock_t end = clock();
+
+			const double ms = (end - start) * 1000.0 / CLOCKS_PER_SEC;
+			totalTime += ms;
+			allocations += s_allocations - allocationsBefore;
+			frames++;
+			if (ms > worstTime) {
+				worstTime = ms;
+				worstFrame = frame;
+			}
+
+			// Only checksum the first run, all runs decode the same frames
+			if (run == 0) {
+				if (surface)
+					checksum = hashSurface(checksum, *surface);
+				if (decoder->hasDirtyPalette())
+					checksum = hashData(checksum, decoder->getPalette(), 256 * 3);
+			}
+		}
+
+		delete decoder;
+	}
+
+	printf("  %8.1f frames/s %8.3f ms/frame, worst %8.3f ms (frame %d), %6.1f allocations/frame, checksum %08x\n",
+		totalTime > 0 ? frames * 1000.0 / totalTime : 0.0, frames ? totalTime / frames : 0.0,
+		worstTime, worstFrame, frames ? (double)allocations / frames : 0.0, checksum);
+
+	total.frames += frames;
+	total.totalTime += totalTime;
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	int runs = 1;
+	int firstFile = 1;
+	if (argc > 2 && !strcmp(argv[1], "-r")) {
+		runs = atoi(argv[2]);
+		firstFile = 3;
+	}
+
+	if (firstFile >= argc || runs < 1) {
+		fprintf(stderr, "Usage: %s [-r runs] file...\n", argv[0]);
+		return 1;
+	}
+
+	BenchSystem *system = new BenchSystem();
+	g_system = system;
+	system->initBackend();
+
+	Result total = { 0, 0.0 };
+	int failed = 0;
+	for (int i = firstFile; i < argc; ++i)
+		if (!benchmarkFile(argv[i], runs, system->getMixer(), total))
+			failed++;
+
+	printf("Total: %d frames in %.1f ms, %.1f frames/s\n", total.frames, total.totalTime,
+		total.totalTime > 0 ? total.frames * 1000.0 / total.totalTime : 0.0);
+
+	delete system;
+	g_system = 0;
+	return failed ? 1 : 0;
+}
@@ -20,7 +20,6 @@
  *
  */
 
-#include "common/stack.h"
 #include "common/system.h"
 
 #include "sci/sci.h"
@@ -863,7 +862,8 @@ void GfxPicture::vectorGetPatternTexture(byte *data, int &curPos, int16 pattern_
 // code. This algo really needs to behave exactly as the one from sierra.
 void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, byte control) {
 	Port *curPort = _ports->getPort();
-	Common::Stack<Common::Point> stack;
+	// The stack is kept between fills, so its memory only gets allocated once
+	Common::Stack<Common::Point> &stack = _floodFillStack;
 	Common::Point p, p1;
 	byte screenMask = _screen->getDrawingMask(color, priority, control);
 	byte matchedMask, matchMask;
@@ -873,7 +873,6 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 
 	p.x = x + curPort->left;
 	p.y = y + curPort->top;
-	stack.push(p);
 
 	byte searchColor = _screen->getVisual(p.x, p.y);
 	byte searchPriority = _screen->getPriority(p.x, p.y);
@@ -928,6 +927,7 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 	int t = curPort->rect.top + curPort->top;
 	int r = curPort->rect.right + curPort->left - 1;
 	int b = curPort->rect.bottom + curPort->top - 1;
+	stack.push(p);
 	while (stack.size()) {
 		p = stack.pop();
 		if ((matchedMask = _screen->isFillMatch(p.x, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)) == 0) // already filled
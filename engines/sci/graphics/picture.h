@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_PICTURE_H
 #define SCI_GRAPHICS_PICTURE_H
 
+#include "common/rect.h"
+#include "common/stack.h"
+
 namespace Sci {
 
 #define SCI_PATTERN_CODE_RECTANGLE 0x10
@@ -97,6 +100,9 @@ private:
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
+
+	// Pending points of vectorFloodFill(), reused by all fills of the picture
+	Common::Stack<Common::Point> _floodFillStack;
 };
 
 } // End of namespace Sci
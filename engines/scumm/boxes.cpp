@@ -85,8 +85,14 @@ struct Box {				/* Internal walkbox file format */
 #define BOX_MATRIX_SIZE 2000
 #define BOX_DEBUG 0
 
+// Never split the room into more horizontal bands than this for the box
+// spatial index; the band height grows instead.
+#define BOX_MAX_BANDS 64
+
 
 static void getGates(const BoxCoords &box1, const BoxCoords &box2, Common::Point gateA[2], Common::Point gateB[2]);
+static void calcBoxBounds(const BoxCoords &box, BoxCache::Bounds &b);
+static bool checkXYInBox(const BoxCoords &box, const BoxCache::Bounds &bounds, int x, int y);
 
 static bool compareSlope(const Common::Point &p1, const Common::Point &p2, const Common::Point &p3) {
 	return (p2.y - p1.y) * (p3.x - p1.x) <= (p3.y - p1.y) * (p2.x - p1.x);
@@ -205,6 +211,12 @@ void ScummEngine::setBoxFlags(int box, int val) {
 			ptr->v2.flags = val;
 		else
 			ptr->old.flags = val;
+
+		// Visibility affects which boxes are neighbors, so the cached
+		// itinerary matrix has to be recomputed.
+		_boxCache.flagsValid = false;
+		_boxCache.itineraryValid = false;
+		_boxCache.matrixValid = false;
 	}
 }
 
@@ -492,21 +504,115 @@ Box *ScummEngine::getBoxBaseAddr(int box) {
 		return (Box *)(ptr + box * SIZEOF_BOX + 2);
 }
 
-int ScummEngine_v6::getSpecialBox(int x, int y) {
-	int i;
-	int numOfBoxes;
-	byte flag;
+void ScummEngine::invalidateBoxCache(bool boxesChanged) {
+	if (boxesChanged) {
+		_boxCache.geometryValid = false;
+		_boxCache.flagsValid = false;
+		_boxCache.itineraryValid = false;
+	}
+	_boxCache.matrixValid = false;
+}
+
+const BoxCache &ScummEngine::getBoxCache() {
+	BoxCache &cache = _boxCache;
+
+	if (!cache.geometryValid) {
+		const int num = getNumBoxes();
+		int top = 0x7FFF, bottom = -0x8000;
+		int i, band;
+
+		cache.numBoxes = num;
+		cache.coords.resize(num);
+		cache.bounds.resize(num);
+
+		for (i = 0; i < num; i++) {
+			const BoxCache::Bounds &b = cache.bounds[i];
+
+			cache.coords[i] = decodeBoxCoordinates(i);
+			calcBoxBounds(cache.coords[i], cache.bounds[i]);
+
+			top = MIN<int>(top, b.minY);
+			bottom = MAX<int>(bottom, b.maxY);
+		}
+
+		// Build the spatial index: split the vertical extent of all boxes
+		// into bands of 2^bandShift rows, and record for each band the
+		// boxes overlapping it, highest box number first (which is the
+		// order in which the engine searches boxes).
+		cache.bandTop = top;
+		cache.bandShift = 4;
+		int numBands = 0;
+		if (num > 0) {
+			while (((bottom - top) >> cache.bandShift) >= BOX_MAX_BANDS)
+				cache.bandShift++;
+			numBands = ((bottom - top) >> cache.bandShift) + 1;
+		}
 
-	numOfBoxes = getNumBoxes() - 1;
+		cache.bandStart.resize(numBands + 1);
+		for (band = 0; band <= numBands; band++)
+			cache.bandStart[band] = 0;
+		for (i = 0; i < num; i++) {
+			const int first = (cache.bounds[i].minY - top) >> cache.bandShift;
+			const int last = (cache.bounds[i].maxY - top) >> cache.bandShift;
+			for (band = first; band <= last; band++)
+				cache.bandStart[band + 1]++;
+		}
+		for (band = 0; band < numBands; band++)
+			cache.bandStart[band + 1] += cache.bandStart[band];
+
+		cache.bandBoxes.resize(numBands > 0 ? cache.bandStart[numBands] : 0);
+		Common::Array<uint16> fill(cache.bandStart);
+		for (i = num - 1; i >= 0; i--) {
+			const int first = (cache.bounds[i].minY - top) >> cache.bandShift;
+			const int last = (cache.bounds[i].maxY - top) >> cache.bandShift;
+			for (band = first; band <= last; band++)
+				cache.bandBoxes[fill[band]++] = i;
+		}
+
+		cache.geometryValid = true;
+	}
+
+	if (!cache.flagsValid) {
+		cache.flags.resize(cache.numBoxes);
+		for (int i = 0; i < cache.numBoxes; i++)
+			cache.flags[i] = getBoxFlags(i);
+		cache.flagsValid = true;
+	}
+
+	return cache;
+}
+
+const byte *BoxCache::getBandBoxes(int y, int &count) const {
+	const int band = (y - bandTop) >> bandShift;
 
-	for (i = numOfBoxes; i >= 0; i--) {
-		flag = getBoxFlags(i);
+	if (y < bandTop || band >= (int)bandStart.size() - 1) {
+		count = 0;
+		return 0;
+	}
 
-		if (!(flag & kBoxInvisible) && (flag & kBoxPlayerOnly))
-			return (-1);
+	count = bandStart[band + 1] - bandStart[band];
+	return count ? &bandBoxes[bandStart[band]] : 0;
+}
 
-		if (checkXYInBoxBounds(i, x, y))
-			return (i);
+int ScummEngine_v6::getSpecialBox(int x, int y) {
+	const BoxCache &cache = getBoxCache();
+	int limit = -1;
+	int i, count;
+
+	// The search stops at the first visible "player only" box, no matter
+	// where the point is; so only boxes above that one can be found.
+	for (i = cache.numBoxes - 1; i >= 0; i--) {
+		const byte flag = cache.flags[i];
+		if (!(flag & kBoxInvisible) && (flag & kBoxPlayerOnly)) {
+			limit = i;
+			break;
+		}
+	}
+
+	const byte *boxes = cache.getBandBoxes(y, count);
+	for (i = 0; i < count && boxes[i] > limit; i++) {
+		if (checkXYInBoxBounds(boxes[i], x, y))
+			return boxes[i];
 	}
 
 	return (-1);
@@ -520,23 +626,34 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 	if (boxnum < 0 || boxnum == Actor::kInvalidBox)
 		return false;
 
-	BoxCoords box = getBoxCoordinates(boxnum);
+	const BoxCache &cache = getBoxCache();
+	if (boxnum >= cache.numBoxes) {
+		// Out of range box numbers are subject to the workarounds in
+		// getBoxBaseAddr(), so leave them to the slow path.
+		const BoxCoords box = decodeBoxCoordinates(boxnum);
+		BoxCache::Bounds bounds;
+		calcBoxBounds(box, bounds);
+		return checkXYInBox(box, bounds, x, y);
+	}
+
+	return checkXYInBox(cache.coords[boxnum], cache.bounds[boxnum], x, y);
+}
+
+static void calcBoxBounds(const BoxCoords &box, BoxCache::Bounds &b) {
+	b.minX = MIN(MIN(box.ul.x, box.ur.x), MIN(box.ll.x, box.lr.x));
+	b.maxX = MAX(MAX(box.ul.x, box.ur.x), MAX(box.ll.x, box.lr.x));
+	b.minY = MIN(MIN(box.ul.y, box.ur.y), MIN(box.ll.y, box.lr.y));
+	b.maxY = MAX(MAX(box.ul.y, box.ur.y), MAX(box.ll.y, box.lr.y));
+}
+
+static bool checkXYInBox(const BoxCoords &box, const BoxCache::Bounds &bounds, int x, int y) {
 	const Common::Point p(x, y);
 
 	// Quick check: If the x (resp. y) coordinate of the point is
 	// strictly smaller (bigger) than the x (y) coordinates of all
 	// corners of the quadrangle, then it certainly is *not* contained
 	// inside the quadrangle.
-	if (x < box.ul.x && x < box.ur.x && x < box.lr.x && x < box.ll.x)
-		return false;
-
-	if (x > box.ul.x && x > box.ur.x && x > box.lr.x && x > box.ll.x)
-		return false;
-
-	if (y < box.ul.y && y < box.ur.y && y < box.lr.y && y < box.ll.y)
-		return false;
-
-	if (y > box.ul.y && y > box.ur.y && y > box.lr.y && y > box.ll.y)
+	if (x < bounds.minX || x > bounds.maxX || y < bounds.minY || y > bounds.maxY)
 		return false;
 
 	// Corner case: If the box is a simple line segment, we consider the
@@ -572,6 +689,16 @@ bool ScummEngine::checkXYInBoxBounds(int boxnum, int x, int y) {
 }
 
 BoxCoords ScummEngine::getBoxCoordinates(int boxnum) {
+	const BoxCache &cache = getBoxCache();
+	if (boxnum >= 0 && boxnum < cache.numBoxes)
+		return cache.coords[boxnum];
+
+	// Out of range box numbers are subject to the workarounds in
+	// getBoxBaseAddr(), so leave them to the slow path.
+	return decodeBoxCoordinates(boxnum);
+}
+
+BoxCoords ScummEngine::decodeBoxCoordinates(int boxnum) {
 	BoxCoords tmp, *box = &tmp;
 	Box *bp = getBoxBaseAddr(boxnum);
 	assert(bp);
@@ -719,9 +846,8 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	boxm = getBoxMatrixBaseAddr();
 
 	if (_game.version == 0) {
-		// calculate shortest paths
-		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
-		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
+		// shortest paths are only recomputed when the boxes change
+		const byte *itineraryMatrix = getItineraryMatrix();
 
 		dest = to;
 		do {
@@ -731,7 +857,6 @@ int ScummEngine::getNextBox(byte from, byte to) {
 		if (dest == Actor::kInvalidBox)
 			dest = -1;
 
-		free(itineraryMatrix);
 		return dest;
 	} else if (_game.version <= 2) {
 		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
@@ -929,7 +1054,7 @@ static void printMatrix(byte *boxm, int num) {
 	}
 }
 
-static void printMatrix2(byte *matrix, int num) {
+static void printMatrix2(const byte *matrix, int num) {
 	int i, j;
 	debug("    ");
 	for (i = 0; i < num; i++)
@@ -1005,18 +1130,41 @@ void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
 	free(adjacentMatrix);
 }
 
+/**
+ * Returns the itinerary matrix for the current boxes, computing it if the
+ * box layout or the box flags changed since it was last computed.
+ */
+const byte *ScummEngine::getItineraryMatrix() {
+	BoxCache &cache = _boxCache;
+
+	if (!cache.itineraryValid) {
+		const int num = getNumBoxes();
+		const uint8 boxSize = (_game.version == 0) ? num : 64;
+
+		debugC(DEBUG_ACTORS, "Computing the itinerary matrix for %d boxes", num);
+
+		cache.itinerary.resize(boxSize * boxSize);
+		if (num > 0)
+			calcItineraryMatrix(&cache.itinerary[0], num);
+		cache.itineraryValid = true;
+	}
+
+	return cache.itinerary.empty() ? 0 : &cache.itinerary[0];
+}
+
 void ScummEngine::createBoxMatrix() {
 	int num, i, j;
 
+	// Scripts tend to call this after every single setBoxFlags; if nothing
+	// changed since the box matrix was last built, it is still up-to-date.
+	if (_boxCache.matrixValid)
+		return;
+
 	// The total number of boxes
 	num = getNumBoxes();
 
 	const uint8 boxSize = (_game.version == 0) ? num : 64;
 
-	// calculate shortest paths
-	byte *itineraryMatrix = (byte *)malloc(boxSize * boxSize);
-	calcItineraryMatrix(itineraryMatrix, num);
-
 	// "Compress" the distance matrix into the box matrix format used
 	// by the engine. The format is like this:
 	// For each box (from 0 to num) there is first a byte with value 0xFF,
@@ -1032,6 +1180,9 @@ void ScummEngine::createBoxMatrix() {
 	byte *matrixStart = _res->createResource(rtMatrix, 1, BOX_MATRIX_SIZE);
 	const byte *matrixEnd = matrixStart + BOX_MATRIX_SIZE;
 
+	// calculate shortest paths
+	const byte *itineraryMatrix = getItineraryMatrix();
+
 	#define addToMatrix(b)	do { *matrixStart++ = (b); assert(matrixStart < matrixEnd); } while (0)
 
 	for (i = 0; i < num; i++) {
@@ -1057,7 +1208,7 @@ void ScummEngine::createBoxMatrix() {
 	printMatrix(getBoxMatrixBaseAddr(), num);
 #endif
 
-	free(itineraryMatrix);
+	_boxCache.matrixValid = true;
 }
 
 /** Check if two boxes are neighbors. */
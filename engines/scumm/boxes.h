@@ -23,6 +23,7 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -49,6 +50,52 @@ struct BoxCoords {			/* Box coordinates */
 	Common::Point lr;
 };
 
+/**
+ * Pre-decoded walkbox data of the current room.
+ *
+ * The geometry is decoded once from the version specific walkbox resource
+ * (rtMatrix 2), together with a bounding rectangle per box and a coarse
+ * spatial index, which maps horizontal bands of the room to the boxes
+ * overlapping them. The itinerary matrix is kept as well, so that it only
+ * has to be recomputed when the box layout or the box flags change.
+ *
+ * Everything in here is derived data: it is rebuilt on demand and dropped
+ * whenever the box resources (rtMatrix 2) are (re)created, e.g. on a room
+ * change, or the box flags change, see ScummEngine::invalidateBoxCache().
+ */
+struct BoxCache {
+	struct Bounds {
+		int16 minX, minY;
+		int16 maxX, maxY;	// inclusive
+	};
+
+	bool geometryValid;
+	bool flagsValid;
+	bool itineraryValid;
+	bool matrixValid;	// rtMatrix 1 was built by createBoxMatrix() from this layout
+
+	int numBoxes;
+	Common::Array<BoxCoords> coords;
+	Common::Array<Bounds> bounds;
+	Common::Array<byte> flags;
+
+	int bandTop;
+	int bandShift;
+	Common::Array<uint16> bandStart;	// numBands + 1 entries
+	Common::Array<byte> bandBoxes;		// box numbers per band, highest box first
+
+	Common::Array<byte> itinerary;
+
+	BoxCache() : geometryValid(false), flagsValid(false), itineraryValid(false), matrixValid(false),
+		numBoxes(0), bandTop(0), bandShift(0) {}
+
+	/**
+	 * Return the boxes whose bounding rectangle overlaps row y, ordered
+	 * from the highest box number to the lowest one.
+	 */
+	const byte *getBandBoxes(int y, int &count) const;
+};
+
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
 } // End of namespace Scumm
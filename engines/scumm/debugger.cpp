@@ -31,6 +31,7 @@
 #include "scumm/debugger.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/object.h"
+#include "scumm/profiler.h"
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
@@ -78,6 +79,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("script",    WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
+	DCmd_Register("profile",   WRAP_METHOD(ScummDebugger, Cmd_Profile));
 	DCmd_Register("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
 
 	if (_vm->_game.id == GID_LOOM)
@@ -330,6 +332,56 @@ bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_Profile(int argc, const char **argv) {
+	ScriptProfiler *profiler = _vm->_scriptProfiler;
+
+	if (argc < 2) {
+		DebugPrintf("Syntax: profile <on | off | reset | report [count] | dump <filename> [time | count]>\n");
+		DebugPrintf("The script profiler is %s\n", profiler->isEnabled() ? "enabled" : "disabled");
+		return true;
+	}
+
+	if (!strcmp(argv[1], "on")) {
+		profiler->setEnabled(true);
+		DebugPrintf("Script profiler enabled\n");
+	} else if (!strcmp(argv[1], "off")) {
+		profiler->setEnabled(false);
+		DebugPrintf("Script profiler disabled\n");
+	} else if (!strcmp(argv[1], "reset")) {
+		profiler->reset();
+		DebugPrintf("Script profile cleared\n");
+	} else if (!strcmp(argv[1], "report")) {
+		const uint maxLines = (argc > 2) ? atoi(argv[2]) : 20;
+		Common::Array<ScriptProfiler::Entry> entries;
+		uint32 totalCount, totalTime;
+
+		profiler->getTotals(totalCount, totalTime);
+		profiler->getReport(entries);
+
+		DebugPrintf("%u opcodes executed in %u ms\n", totalCount, totalTime);
+		DebugPrintf("+----+-----+----------------------------+---------+-------+-----+\n");
+		DebugPrintf("|room|scrpt|opcode                      |    count|   time|   %% |\n");
+		DebugPrintf("+----+-----+----------------------------+---------+-------+-----+\n");
+		for (uint i = 0; i < entries.size() && i < maxLines; i++) {
+			const ScriptProfiler::Entry &e = entries[i];
+			DebugPrintf("|%4d|%5d|%02x %-25.25s|%9u|%7u|%5.1f|\n",
+					e.room, e.script, e.opcode, profiler->getOpcodeName(e.opcode).c_str(),
+					e.count, e.time, totalTime ? e.time * 100.0 / totalTime : 0.0);
+		}
+		DebugPrintf("+----+-----+----------------------------+---------+-------+-----+\n");
+	} else if (!strcmp(argv[1], "dump") && argc > 2) {
+		const bool byCount = (argc > 3 && !strcmp(argv[3], "count"));
+		if (profiler->dumpFoldedStacks(argv[2], byCount))
+			DebugPrintf("Script profile written to '%s'\n", argv[2]);
+		else
+			DebugPrintf("Could not write '%s'\n", argv[2]);
+	} else {
+		DebugPrintf("Unknown profile command '%s'\n", argv[1]);
+	}
+
+	return true;
+}
+
 bool ScummDebugger::Cmd_Actor(int argc, const char **argv) {
 	Actor *a;
 	int actnum;
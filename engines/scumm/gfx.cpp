@@ -572,26 +572,41 @@ void ScummEngine::updateDirtyScreen(VirtScreenNumber slot) {
 	if (vs->h == 0)
 		return;
 
-	int i;
-	int w = 8;
-	int start = 0;
+	for (int i = 0; i < _gdi->_numStrips; i++) {
+		if (!vs->bdirty[i])
+			continue;
+
+		const int start = i;
+		int top = vs->tdirty[i];
+		int bottom = vs->bdirty[i];
+		int dirtyArea = MAX(bottom - top, 0);
+		vs->tdirty[i] = vs->h;
+		vs->bdirty[i] = 0;
+
+		// Coalesce neighboring dirty strips into one bigger rectangle, as
+		// long as the union stays mostly dirty. Fewer, larger blits are far
+		// cheaper for the backend than many narrow ones, but we do not want
+		// to upload big clean areas just to save a call.
+		while (i + 1 < _gdi->_numStrips && vs->bdirty[i + 1]) {
+			const int nextTop = vs->tdirty[i + 1];
+			const int nextBottom = vs->bdirty[i + 1];
+			const int newTop = MIN(top, nextTop);
+			const int newBottom = MAX(bottom, nextBottom);
+			const int newArea = dirtyArea + MAX(nextBottom - nextTop, 0);
+
+			// Allow at most 20% of the merged rectangle to be clean
+			if ((newBottom - newTop) * (i + 2 - start) * 4 > newArea * 5)
+				break;
 
-	for (i = 0; i < _gdi->_numStrips; i++) {
-		if (vs->bdirty[i]) {
-			const int top = vs->tdirty[i];
-			const int bottom = vs->bdirty[i];
+			i++;
+			top = newTop;
+			bottom = newBottom;
+			dirtyArea = newArea;
 			vs->tdirty[i] = vs->h;
 			vs->bdirty[i] = 0;
-			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top) {
-				// Simple optimizations: if two or more neighboring strips
-				// form one bigger rectangle, coalesce them.
-				w += 8;
-				continue;
-			}
-			drawStripToScreen(vs, start * 8, w, top, bottom);
-			w = 8;
 		}
-		start = i + 1;
+
+		drawStripToScreen(vs, start * 8, (i + 1 - start) * 8, top, bottom);
 	}
 }
 
@@ -662,22 +677,46 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 			const byte *srcPtr = (const byte *)src;
 			const byte *textPtr = (byte *)_textSurface.getBasePtr(x * m, y * m);
 			byte *dstPtr = _compositeBuf;
+			const int srcBpp = vs->format.bytesPerPixel;
+			const int rowWidth = width * m;
 
 			for (int h = 0; h < height * m; ++h) {
-				for (int w = 0; w < width * m; ++w) {
-					uint16 tmp = *textPtr++;
-					if (tmp == CHARSET_MASK_TRANSPARENCY) {
-						tmp = READ_UINT16(srcPtr);
-						WRITE_UINT16(dstPtr, tmp); dstPtr += 2;
-					} else if (_game.heversion != 0) {
-						error ("16Bit Color HE Game using old charset");
+				int w = 0;
+				while (w < rowWidth) {
+					// Find the run of transparent text pixels starting here.
+					// Most of the text surface is empty, so check four mask
+					// bytes at a time before falling back to single bytes.
+					int end = w;
+					while (end + 4 <= rowWidth && READ_UINT32(textPtr + end) == CHARSET_MASK_TRANSPARENCY_32)
+						end += 4;
+					while (end < rowWidth && textPtr[end] == CHARSET_MASK_TRANSPARENCY)
+						end++;
+
+					// The game graphics show through the whole run
+					if (srcBpp == 2) {
+						const int len = (end - w) * 2;
+						memcpy(dstPtr, srcPtr, len);
+						dstPtr += len;
+						srcPtr += len;
 					} else {
-						WRITE_UINT16(dstPtr, _16BitPalette[tmp]); dstPtr += 2;
+						for (int i = w; i < end; ++i) {
+							WRITE_UINT16(dstPtr, READ_UINT16(srcPtr)); dstPtr += 2;
+							srcPtr += srcBpp;
+						}
+					}
+					w = end;
+
+					// Followed by a run of text pixels
+					if (w < rowWidth && _game.heversion != 0)
+						error ("16Bit Color HE Game using old charset");
+					while (w < rowWidth && textPtr[w] != CHARSET_MASK_TRANSPARENCY) {
+						WRITE_UINT16(dstPtr, _16BitPalette[textPtr[w]]); dstPtr += 2;
+						srcPtr += srcBpp;
+						w++;
 					}
-					srcPtr += vs->format.bytesPerPixel;
 				}
 				srcPtr += vsPitch;
-				textPtr += _textSurface.pitch - width * m;
+				textPtr += _textSurface.pitch;
 			}
 		}
 #ifdef USE_ARM_GFX_ASM
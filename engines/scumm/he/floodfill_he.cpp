@@ -22,6 +22,8 @@
 
 #ifdef ENABLE_HE
 
+#include "graphics/primitives.h"
+
 #include "scumm/he/floodfill_he.h"
 #include "scumm/he/intern_he.h"
 #include "scumm/resource.h"
@@ -29,149 +31,42 @@
 
 namespace Scumm {
 
-static bool floodFillPixelCheck(int x, int y, const FloodFillState *ffs) {
-	int diffColor = ffs->color1 - ffs->color2;
-	if (x >= 0 && x < ffs->dst_w && y >= 0 && y < ffs->dst_h) {
-		uint8 color = *(ffs->dst + y * ffs->dst_w + x);
-		diffColor = color - ffs->color1;
-	}
-	return diffColor == 0;
-}
-
-static void floodFillProcessRect(FloodFillState *ffs, const Common::Rect *r) {
-	Common::Rect *dr = &ffs->dstBox;
-	if (dr->right >= dr->left && dr->top <= dr->bottom) {
-		int rw = r->right - r->left + 1;
-		int rh = r->bottom - r->top + 1;
-		assert(r->top + rh <= ffs->dst_h);
-		assert(r->left + rw <= ffs->dst_w);
-		uint8 *dst = ffs->dst + r->top * ffs->dst_w + r->left;
-		if (rw <= 1) {
-			--rh;
-			while (rh >= 0) {
-				*dst = ffs->color2;
-				dst += ffs->dst_w;
-				--rh;
-			}
-		} else {
-			--rh;
-			while (rh >= 0) {
-				memset(dst, ffs->color2, rw);
-				dst += ffs->dst_w;
-				--rh;
-			}
-		}
-		dr->extend(*r);
+/**
+ * Fill the area of matching color around (x, y) in an 8bpp buffer.
+ * The box is inclusive, as used by the scripts. On return, dirty holds
+ * the (inclusive) rectangle that was filled, if any.
+ *
+ * Unlike the original point by point fill, a seed point outside the box
+ * fills nothing.
+ */
+static bool floodFillBuffer(uint8 *dst, int w, int h, const Common::Rect &box, int x, int y, uint8 color, Common::Rect &dirty, int debugLevel) {
+	int color1;
+	if (x < 0 || y < 0 || x >= w || y >= h) {
+		color1 = color;
 	} else {
-		*dr = *r;
+		color1 = *(dst + y * w + x);
 	}
-}
 
-static void floodFillAddLine(FloodFillLine **ffl, int y, int x1, int x2, int dy) {
-	(*ffl)->y = y;
-	(*ffl)->x1 = x1;
-	(*ffl)->x2 = x2;
-	(*ffl)->inc = dy;
-	(*ffl)++;
-}
-
-static void floodFillProcess(int x, int y, FloodFillState *ffs, FloodFillPixelCheckCallback pixelCheckCallback) {
-	ffs->dstBox.left = ffs->dstBox.top = 12345;
-	ffs->dstBox.right = ffs->dstBox.bottom = -12345;
-
-	FloodFillLine **fillLineCur = &ffs->fillLineTableCur;
-	FloodFillLine **fillLineEnd = &ffs->fillLineTableEnd;
-
-	assert(*fillLineCur < *fillLineEnd);
-	if (ffs->srcBox.top <= y + 1 && ffs->srcBox.bottom >= y + 1) {
-		(*fillLineCur)->y = y;
-		(*fillLineCur)->x1 = x;
-		(*fillLineCur)->x2 = x;
-		(*fillLineCur)->inc = 1;
-		(*fillLineCur)++;
-	}
-
-	assert(*fillLineCur < *fillLineEnd);
-	if (ffs->srcBox.top <= y && ffs->srcBox.bottom >= y) {
-		(*fillLineCur)->y = y + 1;
-		(*fillLineCur)->x1 = x;
-		(*fillLineCur)->x2 = x;
-		(*fillLineCur)->inc = -1;
-		(*fillLineCur)++;
-	}
-
-	assert(ffs->fillLineTable <= *fillLineCur);
-	FloodFillLine **fillLineStart = fillLineCur;
-
-	while (ffs->fillLineTable < *fillLineStart) {
-		Common::Rect r;
-		int x_start;
-		FloodFillLine *fflCur = --(*fillLineCur);
-		int dy = fflCur->inc;
-		int x_end = fflCur->x2;
-		int x1 = fflCur->x1;
-		int x2 = fflCur->x1 + 1;
-		r.bottom = r.top = y = fflCur->y + fflCur->inc;
-		r.left = x2;
-		r.right = x1;
-		x = x1;
-		while (ffs->srcBox.left <= x) {
-			if (!(*pixelCheckCallback)(x, y, ffs)) {
-				break;
-			}
-			r.left = x;
-			--x;
-		}
-		if (r.right >= r.left && r.top <= r.bottom) {
-			floodFillProcessRect(ffs, &r);
-		}
-		if (x >= x1) goto skip;
-		x_start = x + 1;
-		if (x1 > x_start) {
-			assert(*fillLineEnd > *fillLineCur);
-			if (ffs->srcBox.top <= y - dy && ffs->srcBox.bottom >= y - dy) {
-				--x1;
-				floodFillAddLine(fillLineCur, y, x_start, x1, -dy);
-			}
-		}
-		x = x2;
-		while (x_start <= x_end) {
-			r.left = x;
-			r.top = y;
-			r.right = x - 1;
-			r.bottom = y;
-			while (ffs->srcBox.right >= x) {
-				if (!(*pixelCheckCallback)(x, y, ffs)) {
-					break;
-				}
-				r.right = x;
-				++x;
-			}
-			if (r.right >= r.left && r.top <= r.bottom) {
-				floodFillProcessRect(ffs, &r);
-			}
-			assert(ffs->fillLineTableCur < ffs->fillLineTableEnd);
-			if (ffs->srcBox.top <= y + dy && ffs->srcBox.bottom >= y + dy) {
-				floodFillAddLine(&ffs->fillLineTableCur, y, x_start, x - 1, dy);
-			}
-			x_start = x_end + 1;
-			if (x > x_start) {
-				assert(ffs->fillLineTableCur < ffs->fillLineTableEnd);
-				if (ffs->srcBox.top <= y - dy && ffs->srcBox.bottom >= y - dy) {
-					floodFillAddLine(&ffs->fillLineTableCur, y, x_start, x - 1, -dy);
-				}
-			}
-skip:
-			++x;
-			while (x <= x_end) {
-				if ((*pixelCheckCallback)(x, y, ffs)) {
-					break;
-				}
-				++x;
-			}
-			x_start = x;
-		}
-	}
+	debug(debugLevel, "floodFill() x=%d y=%d color1=%d", x, y, color1);
+	if (color1 == color)
+		return false;
+
+	Common::Rect bounds;
+	bounds.left = box.left;
+	bounds.top = box.top;
+	bounds.right = box.right + 1;
+	bounds.bottom = box.bottom + 1;
+	bounds.clip(Common::Rect(w, h));
+
+	Graphics::FloodFill ff(h * 2);
+	ff.setBounds(bounds);
+	if (!ff.fill(dst, w, x, y, color))
+		return false;
+
+	dirty = ff.getFilledRect();
+	dirty.right--;
+	dirty.bottom--;
+	return true;
 }
 
 void floodFill(FloodFillParameters *ffp, ScummEngine_v90he *vm) {
@@ -188,33 +83,10 @@ void floodFill(FloodFillParameters *ffp, ScummEngine_v90he *vm) {
 	r.left = r.top = 12345;
 	r.right = r.bottom = -12345;
 
-	FloodFillState *ffs = new FloodFillState;
-	ffs->fillLineTableCount = vs->h * 2;
-	ffs->fillLineTable = new FloodFillLine[ffs->fillLineTableCount];
-	ffs->color2 = color;
-	ffs->dst = dst;
-	ffs->dst_w = vs->w;
-	ffs->dst_h = vs->h;
-	ffs->srcBox = ffp->box;
-	ffs->fillLineTableCur = &ffs->fillLineTable[0];
-	ffs->fillLineTableEnd = &ffs->fillLineTable[ffs->fillLineTableCount];
-
-	if (ffp->x < 0 || ffp->y < 0 || ffp->x >= vs->w || ffp->y >= vs->h) {
-		ffs->color1 = color;
-	} else {
-		ffs->color1 = *(dst + ffp->y * vs->w + ffp->x);
-	}
-
-	debug(5, "floodFill() x=%d y=%d color1=%d ffp->flags=0x%X", ffp->x, ffp->y, ffs->color1, ffp->flags);
-	if (ffs->color1 != color) {
-		floodFillProcess(ffp->x, ffp->y, ffs, floodFillPixelCheck);
-		r = ffs->dstBox;
-	}
+	debug(5, "floodFill() ffp->flags=0x%X", ffp->flags);
+	floodFillBuffer(dst, vs->w, vs->h, ffp->box, ffp->x, ffp->y, color, r, 5);
 	r.debugPrint(5, "floodFill() dirty_rect");
 
-	delete[] ffs->fillLineTable;
-	delete ffs;
-
 	vm->VAR(119) = 1;
 
 	if (r.left <= r.right && r.top <= r.bottom) {
@@ -258,31 +130,8 @@ void Wiz::fillWizFlood(const WizParameters *params) {
 				uint8 *wizd = _vm->findWrappedBlock(MKTAG('W','I','Z','D'), dataPtr, state, 0);
 				assert(wizd);
 
-				FloodFillState *ffs = new FloodFillState;
-				ffs->fillLineTableCount = h * 2;
-				ffs->fillLineTable = new FloodFillLine[ffs->fillLineTableCount];
-				ffs->color2 = color;
-				ffs->dst = wizd;
-				ffs->dst_w = w;
-				ffs->dst_h = h;
-				ffs->srcBox = imageRect;
-				ffs->fillLineTableCur = &ffs->fillLineTable[0];
-				ffs->fillLineTableEnd = &ffs->fillLineTable[ffs->fillLineTableCount];
-
-				if (px < 0 || py < 0 || px >= w || py >= h) {
-					ffs->color1 = color;
-				} else {
-					ffs->color1 = *(wizd + py * w + px);
-				}
-
-				debug(0, "floodFill() x=%d y=%d color1=%d", px, py, ffs->color1);
-
-				if (ffs->color1 != color) {
-					floodFillProcess(px, py, ffs, floodFillPixelCheck);
-				}
-
-				delete[] ffs->fillLineTable;
-				delete ffs;
+				Common::Rect dirty;
+				floodFillBuffer(wizd, w, h, imageRect, px, py, color, dirty, 0);
 			}
 		}
 	}
@@ -34,31 +34,8 @@ struct FloodFillParameters {
 	int32 flags;
 };
 
-struct FloodFillLine {
-	int y;
-	int x1;
-	int x2;
-	int inc;
-};
-
-struct FloodFillState {
-	FloodFillLine *fillLineTable;
-	FloodFillLine *fillLineTableEnd;
-	FloodFillLine *fillLineTableCur;
-	Common::Rect dstBox;
-	Common::Rect srcBox;
-	uint8 *dst;
-	int dst_w;
-	int dst_h;
-	int color1;
-	int color2;
-	int fillLineTableCount;
-};
-
 class ScummEngine_v90he;
 
-typedef bool (*FloodFillPixelCheckCallback)(int x, int y, const FloodFillState *ffs);
-
 void floodFill(FloodFillParameters *ffp, ScummEngine_v90he *vm);
 
 } // End of namespace Scumm
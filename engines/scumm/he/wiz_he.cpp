@@ -508,7 +508,7 @@ void Wiz::copyMaskWizImage(uint8 *dst, const uint8 *src, const uint8 *mask, int
 					}
 					while (code--) {
 						if (*maskPtr != 5)
-							write16BitColor<kWizCopy>(dstPtr, dataPtr, dstType, palPtr);
+							writeColor(dstPtr, dstType, READ_LE_UINT16(dataPtr));
 						dataPtr += 2;
 						dstPtr += dstInc;
 					}
@@ -521,7 +521,7 @@ void Wiz::copyMaskWizImage(uint8 *dst, const uint8 *src, const uint8 *mask, int
 					}
 					while (code--) {
 						if (*maskPtr != 5)
-							write16BitColor<kWizCopy>(dstPtr, dataPtr, dstType, palPtr);
+							writeColor(dstPtr, dstType, READ_LE_UINT16(dataPtr));
 						dataPtr += 2;
 						dstPtr += dstInc;
 						maskPtr++;
@@ -686,32 +686,152 @@ void Wiz::copyRawWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstTyp
 	}
 }
 
-#ifdef USE_RGB_COLOR
-template <int type>
-void Wiz::write16BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const uint8 *xmapPtr) {
-	uint16 col = READ_LE_UINT16(dataPtr);
-	if (type == kWizXMap) {
-		uint16 srcColor = (col >> 1) & 0x7DEF;
-		uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
-		uint16 newColor = srcColor + dstColor;
-		writeColor(dstPtr, dstType, newColor);
+/**
+ * Span writers for the RLE decoders below. Instead of going through
+ * writeColor() for every single pixel, whole runs are handed over at once,
+ * and all per pixel decisions are made at compile time:
+ *  - type:    kWizXMap, kWizRMap or kWizCopy
+ *  - srcBpp:  bytes per pixel in the compressed data (1 or 2)
+ *  - dstBpp:  bytes per pixel of the destination (1 or 2)
+ *  - le:      16 bit pixels are written in little endian order
+ *             (kDstMemory, kDstResource) instead of native order
+ *  - step:    1, or -1 when the image is flipped horizontally
+ *
+ * fill() writes 'count' pixels of the single color at 'src', copy() writes
+ * 'count' consecutive colors from 'src'. In both cases 'dst' points to the
+ * first destination pixel, and the following pixels are at 'dst' + step.
+ */
+template<int type, int srcBpp, int dstBpp, bool le, int step>
+struct WizSpan {
+	enum {
+		kSrcBpp = srcBpp,
+		kDstInc = dstBpp * step,
+#if defined(SCUMM_LITTLE_ENDIAN)
+		kNativeOrder = 1,
+		// Whether the little endian 16 bit source pixels can be copied as is
+		kSameOrder = 1
+#else
+		kNativeOrder = !le,
+		kSameOrder = le
+#endif
+	};
+
+	static inline uint16 readColor(const uint8 *src, const uint8 *palPtr) {
+		if (srcBpp == 2)
+			return READ_LE_UINT16(src);
+		if (type == kWizCopy)
+			return *src;
+		return READ_LE_UINT16(palPtr + *src * 2);
 	}
-	if (type == kWizCopy) {
-		writeColor(dstPtr, dstType, col);
+
+	static inline void writeColor(uint8 *dst, uint16 color) {
+		if (le)
+			WRITE_LE_UINT16(dst, color);
+		else
+			WRITE_UINT16(dst, color);
 	}
-}
 
-template <int type>
-void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
-	const uint8 *dataPtr, *dataPtrNext;
-	uint8 code;
-	uint8 *dstPtr, *dstPtrNext;
-	int h, w, xoff, dstInc;
+	// The shadow mode of 16 bit images averages source and destination by
+	// halving both; the mask keeps the halved components from interfering.
+	// This also works for two pixels packed into a 32 bit word at once.
+	static inline uint16 halfColor(uint16 color) {
+		return (color >> 1) & 0x7DEF;
+	}
 
-	if (type == kWizXMap) {
-		assert(xmapPtr != 0);
+	static inline uint32 halfColor2(uint32 colors) {
+		return (colors >> 1) & 0x7DEF7DEF;
 	}
 
+	static void fill(uint8 *dst, const uint8 *src, int count, const uint8 *palPtr, const uint8 *xmapPtr) {
+		if (dstBpp == 1) {
+			if (type == kWizXMap) {
+				const uint8 *map = xmapPtr + *src * 256;
+				while (count--) {
+					*dst = map[*dst];
+					dst += step;
+				}
+			} else {
+				const uint8 color = (type == kWizRMap) ? palPtr[*src] : *src;
+				memset((step > 0) ? dst : dst - count + 1, color, count);
+			}
+			return;
+		}
+
+		const uint16 color = readColor(src, palPtr);
+		if (type == kWizXMap) {
+			const uint16 srcColor = halfColor(color);
+			if (step > 0 && kNativeOrder) {
+				const uint32 srcColor2 = srcColor * 0x10001;
+				for (; count >= 2; count -= 2, dst += 4)
+					WRITE_UINT32(dst, srcColor2 + halfColor2(READ_UINT32(dst)));
+			}
+			for (; count > 0; count--, dst += kDstInc)
+				writeColor(dst, srcColor + halfColor(READ_UINT16(dst)));
+		} else {
+			for (; count > 0; count--, dst += kDstInc)
+				writeColor(dst, color);
+		}
+	}
+
+	static void copy(uint8 *dst, const uint8 *src, int count, const uint8 *palPtr, const uint8 *xmapPtr) {
+		if (dstBpp == 1) {
+			if (type == kWizXMap) {
+				for (; count > 0; count--, src++, dst += step)
+					*dst = xmapPtr[*src * 256 + *dst];
+			} else if (type == kWizRMap) {
+				for (; count >= 4; count -= 4, src += 4, dst += 4 * step) {
+					dst[0] = palPtr[src[0]];
+					dst[step] = palPtr[src[1]];
+					dst[2 * step] = palPtr[src[2]];
+					dst[3 * step] = palPtr[src[3]];
+				}
+				for (; count > 0; count--, src++, dst += step)
+					*dst = palPtr[*src];
+			} else if (step > 0) {
+				memcpy(dst, src, count);
+			} else {
+				for (; count > 0; count--, src++, dst--)
+					*dst = *src;
+			}
+			return;
+		}
+
+		if (type == kWizXMap) {
+			if (srcBpp == 2 && step > 0 && kNativeOrder) {
+				for (; count >= 2; count -= 2, src += 4, dst += 4) {
+					const uint32 srcColor2 = READ_LE_UINT16(src) | (READ_LE_UINT16(src + 2) << 16);
+#if defined(SCUMM_LITTLE_ENDIAN)
+					WRITE_UINT32(dst, halfColor2(srcColor2) + halfColor2(READ_UINT32(dst)));
+#else
+					WRITE_UINT32(dst, halfColor2((srcColor2 << 16) | (srcColor2 >> 16)) + halfColor2(READ_UINT32(dst)));
+#endif
+				}
+			}
+			for (; count > 0; count--, src += srcBpp, dst += kDstInc)
+				writeColor(dst, halfColor(readColor(src, palPtr)) + halfColor(READ_UINT16(dst)));
+		} else if (srcBpp == 2 && step > 0 && kSameOrder) {
+			// The compressed data is in the destination byte order already
+			memcpy(dst, src, count * 2);
+		} else {
+			for (; count > 0; count--, src += srcBpp, dst += kDstInc)
+				writeColor(dst, readColor(src, palPtr));
+		}
+	}
+};
+
+/**
+ * Decode the rows 'srcRect' of a RLE compressed Wiz image to 'dst', using
+ * the span writer 'Span'. Transparent runs are skipped over, while solid
+ * and literal runs are written a whole span at a time.
+ */
+template<class Span>
+static void decompressWizSpans(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr) {
+	const int srcBpp = Span::kSrcBpp;
+	const int dstInc = Span::kDstInc;
+	const uint8 *dataPtr, *dataPtrNext;
+	uint8 *dstPtr, *dstPtrNext;
+	int h, w, xoff, code;
+
 	dstPtr = dst;
 	dataPtr = src;
 
@@ -729,10 +849,8 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 		dstPtr += (h - 1) * dstPitch;
 		dstPitch = -dstPitch;
 	}
-	dstInc = 2;
-	if (flags & kWIFFlipX) {
-		dstPtr += (w - 1) * 2;
-		dstInc = -2;
+	if (dstInc < 0) {
+		dstPtr -= (w - 1) * dstInc;
 	}
 
 	while (h--) {
@@ -745,6 +863,7 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 			while (w > 0) {
 				code = *dataPtr++;
 				if (code & 1) {
+					// Transparent run
 					code >>= 1;
 					if (xoff > 0) {
 						xoff -= code;
@@ -756,45 +875,43 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 					dstPtr += dstInc * code;
 					w -= code;
 				} else if (code & 2) {
+					// Run of a single color
 					code = (code >> 2) + 1;
 					if (xoff > 0) {
 						xoff -= code;
-						dataPtr += 2;
-						if (xoff >= 0)
+						if (xoff >= 0) {
+							dataPtr += srcBpp;
 							continue;
+						}
 
 						code = -xoff;
-						dataPtr -= 2;
 					}
 					w -= code;
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dstPtr += dstInc;
-					}
-					dataPtr += 2;
+					Span::fill(dstPtr, dataPtr, code, palPtr, xmapPtr);
+					dstPtr += dstInc * code;
+					dataPtr += srcBpp;
 				} else {
+					// Literal colors
 					code = (code >> 2) + 1;
 					if (xoff > 0) {
 						xoff -= code;
-						dataPtr += code * 2;
+						dataPtr += code * srcBpp;
 						if (xoff >= 0)
 							continue;
 
 						code = -xoff;
-						dataPtr += xoff * 2;
+						dataPtr += xoff * srcBpp;
 					}
 					w -= code;
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dataPtr += 2;
-						dstPtr += dstInc;
-					}
+					Span::copy(dstPtr, dataPtr, code, palPtr, xmapPtr);
+					dstPtr += dstInc * code;
+					dataPtr += code * srcBpp;
 				}
 			}
 		}
@@ -802,43 +919,44 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 		dstPtr = dstPtrNext;
 	}
 }
-#endif
 
+template<int type, int srcBpp, int dstBpp, bool le>
+static void decompressWizSpans(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr) {
+	if (flags & kWIFFlipX)
+		decompressWizSpans<WizSpan<type, srcBpp, dstBpp, le, -1> >(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
+	else
+		decompressWizSpans<WizSpan<type, srcBpp, dstBpp, le, 1> >(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
+}
+
+static bool isLittleEndianDst(int dstType) {
+	switch (dstType) {
+	case kDstCursor:
+	case kDstScreen:
+		return false;
+	case kDstMemory:
+	case kDstResource:
+		return true;
+	default:
+		error("decompressWizImage: Unknown dstType %d", dstType);
+	}
+}
+
+#ifdef USE_RGB_COLOR
 template <int type>
-void Wiz::write8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
-	if (bitDepth == 2) {
-		if (type == kWizXMap) {
-			uint16 color = READ_LE_UINT16(palPtr + *dataPtr * 2);
-			uint16 srcColor = (color >> 1) & 0x7DEF;
-			uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
-			uint16 newColor = srcColor + dstColor;
-			writeColor(dstPtr, dstType, newColor);
-		}
-		if (type == kWizRMap) {
-			writeColor(dstPtr, dstType, READ_LE_UINT16(palPtr + *dataPtr * 2));
-		}
-		if (type == kWizCopy) {
-			writeColor(dstPtr, dstType, *dataPtr);
-		}
-	} else {
-		if (type == kWizXMap) {
-			*dstPtr = xmapPtr[*dataPtr * 256 + *dstPtr];
-		}
-		if (type == kWizRMap) {
-			*dstPtr = palPtr[*dataPtr];
-		}
-		if (type == kWizCopy) {
-			*dstPtr = *dataPtr;
-		}
+void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
+	if (type == kWizXMap) {
+		assert(xmapPtr != 0);
 	}
+
+	if (isLittleEndianDst(dstType))
+		decompressWizSpans<type, 2, 2, true>(dst, dstPitch, src, srcRect, flags, NULL, xmapPtr);
+	else
+		decompressWizSpans<type, 2, 2, false>(dst, dstPitch, src, srcRect, flags, NULL, xmapPtr);
 }
+#endif
 
 template <int type>
 void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
-	const uint8 *dataPtr, *dataPtrNext;
-	uint8 code, *dstPtr, *dstPtrNext;
-	int h, w, xoff, dstInc;
-
 	if (type == kWizXMap) {
 		assert(xmapPtr != 0);
 	}
@@ -846,94 +964,13 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 		assert(palPtr != 0);
 	}
 
-	dstPtr = dst;
-	dataPtr = src;
-
-	// Skip over the first 'srcRect->top' lines in the data
-	h = srcRect.top;
-	while (h--) {
-		dataPtr += READ_LE_UINT16(dataPtr) + 2;
-	}
-	h = srcRect.height();
-	w = srcRect.width();
-	if (h <= 0 || w <= 0)
-		return;
-
-	if (flags & kWIFFlipY) {
-		dstPtr += (h - 1) * dstPitch;
-		dstPitch = -dstPitch;
-	}
-	dstInc = bitDepth;
-	if (flags & kWIFFlipX) {
-		dstPtr += (w - 1) * bitDepth;
-		dstInc = -bitDepth;
-	}
-
-	while (h--) {
-		xoff = srcRect.left;
-		w = srcRect.width();
-		uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
-		dstPtrNext = dstPtr + dstPitch;
-		dataPtrNext = dataPtr + lineSize;
-		if (lineSize != 0) {
-			while (w > 0) {
-				code = *dataPtr++;
-				if (code & 1) {
-					code >>= 1;
-					if (xoff > 0) {
-						xoff -= code;
-						if (xoff >= 0)
-							continue;
-
-						code = -xoff;
-					}
-					dstPtr += dstInc * code;
-					w -= code;
-				} else if (code & 2) {
-					code = (code >> 2) + 1;
-					if (xoff > 0) {
-						xoff -= code;
-						++dataPtr;
-						if (xoff >= 0)
-							continue;
-
-						code = -xoff;
-						--dataPtr;
-					}
-					w -= code;
-					if (w < 0) {
-						code += w;
-					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dstPtr += dstInc;
-					}
-					dataPtr++;
-				} else {
-					code = (code >> 2) + 1;
-					if (xoff > 0) {
-						xoff -= code;
-						dataPtr += code;
-						if (xoff >= 0)
-							continue;
-
-						code = -xoff;
-						dataPtr += xoff;
-					}
-					w -= code;
-					if (w < 0) {
-						code += w;
-					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dataPtr++;
-						dstPtr += dstInc;
-					}
-				}
-			}
-		}
-		dataPtr = dataPtrNext;
-		dstPtr = dstPtrNext;
+	if (bitDepth == 2) {
+		if (isLittleEndianDst(dstType))
+			decompressWizSpans<type, 1, 2, true>(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
+		else
+			decompressWizSpans<type, 1, 2, false>(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
+	} else {
+		decompressWizSpans<type, 1, 1, false>(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
 	}
 }
 
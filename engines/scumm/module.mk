@@ -46,6 +46,7 @@ MODULE_OBJS := \
 	player_v2cms.o \
 	player_v3a.o \
 	player_v4a.o \
+	profiler.o \
 	resource_v2.o \
 	resource_v3.o \
 	resource_v4.o \
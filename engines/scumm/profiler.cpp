@@ -0,0 +1,204 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/file.h"
+#include "common/system.h"
+
+#include "scumm/profiler.h"
+#include "scumm/scumm.h"
+
+namespace Scumm {
+
+ScriptProfiler::ScriptProfiler(ScummEngine *vm) : _vm(vm), _enabled(false) {
+	reset();
+}
+
+void ScriptProfiler::setEnabled(bool enable) {
+	_enabled = enable;
+	_depth = 0;
+	_overflow = 0;
+}
+
+void ScriptProfiler::reset() {
+	Node root;
+	root.parent = 0;
+	root.room = -1;
+	root.script = -1;
+	root.opcode = 0;
+	root.count = 0;
+	root.time = 0;
+
+	_nodes.clear();
+	_nodes.push_back(root);
+	_nodeMap.clear();
+	_depth = 0;
+	_overflow = 0;
+}
+
+void ScriptProfiler::beginOpcode(int room, int script, byte opcode) {
+	// Opcodes can run nested scripts, which in turn run opcodes. Should
+	// this go deeper than we can track, simply stop recording until we
+	// are back at a sane depth.
+	if (_depth == kMaxDepth) {
+		_overflow++;
+		return;
+	}
+
+	NodeKey key;
+	key.parent = _depth ? _stack[_depth - 1].node : 0;
+	key.room = room;
+	key.script = script;
+	key.opcode = opcode;
+
+	uint32 node;
+	NodeMap::const_iterator i = _nodeMap.find(key);
+	if (i != _nodeMap.end()) {
+		node = i->_value;
+	} else {
+		Node n;
+		n.parent = key.parent;
+		n.room = room;
+		n.script = script;
+		n.opcode = opcode;
+		n.count = 0;
+		n.time = 0;
+
+		node = _nodes.size();
+		_nodes.push_back(n);
+		_nodeMap[key] = node;
+	}
+
+	Frame &f = _stack[_depth++];
+	f.node = node;
+	f.childTime = 0;
+	f.start = g_system->getMillis();
+}
+
+void ScriptProfiler::endOpcode() {
+	if (_overflow) {
+		_overflow--;
+		return;
+	}
+	if (!_depth)
+		return;
+
+	const Frame &f = _stack[--_depth];
+	const uint32 elapsed = g_system->getMillis() - f.start;
+
+	Node &n = _nodes[f.node];
+	n.count++;
+	n.time += (elapsed > f.childTime) ? elapsed - f.childTime : 0;
+
+	if (_depth)
+		_stack[_depth - 1].childTime += elapsed;
+}
+
+void ScriptProfiler::getTotals(uint32 &count, uint32 &time) const {
+	count = time = 0;
+	for (uint i = 1; i < _nodes.size(); i++) {
+		count += _nodes[i].count;
+		time += _nodes[i].time;
+	}
+}
+
+struct ProfileEntryLess {
+	bool operator()(const ScriptProfiler::Entry &a, const ScriptProfiler::Entry &b) const {
+		if (a.time != b.time)
+			return a.time > b.time;
+		return a.count > b.count;
+	}
+};
+
+void ScriptProfiler::getReport(Common::Array<Entry> &entries) const {
+	// Merge the nodes of the call tree which only differ in their callers
+	typedef Common::HashMap<NodeKey, uint32, NodeKey_Hash, NodeKey_EqualTo> EntryMap;
+	EntryMap index;
+
+	entries.clear();
+	for (uint i = 1; i < _nodes.size(); i++) {
+		const Node &n = _nodes[i];
+		NodeKey key;
+		key.parent = 0;
+		key.room = n.room;
+		key.script = n.script;
+		key.opcode = n.opcode;
+
+		EntryMap::const_iterator e = index.find(key);
+		if (e != index.end()) {
+			entries[e->_value].count += n.count;
+			entries[e->_value].time += n.time;
+		} else {
+			Entry entry;
+			entry.room = n.room;
+			entry.script = n.script;
+			entry.opcode = n.opcode;
+			entry.count = n.count;
+			entry.time = n.time;
+
+			index[key] = entries.size();
+			entries.push_back(entry);
+		}
+	}
+
+	Common::sort(entries.begin(), entries.end(), ProfileEntryLess());
+}
+
+bool ScriptProfiler::dumpFoldedStacks(const Common::String &filename, bool byCount) const {
+	Common::DumpFile out;
+	if (!out.open(filename))
+		return false;
+
+	Common::Array<uint32> chain;
+	for (uint i = 1; i < _nodes.size(); i++) {
+		const Node &n = _nodes[i];
+		const uint32 value = byCount ? n.count : n.time;
+		if (!value)
+			continue;
+
+		chain.clear();
+		for (uint32 node = i; node != 0; node = _nodes[node].parent)
+			chain.push_back(node);
+
+		Common::String line;
+		for (int j = chain.size() - 1; j >= 0; j--) {
+			const Node &frame = _nodes[chain[j]];
+			if (!line.empty())
+				line += ';';
+			line += Common::String::format("room-%d;script-%d;%s", frame.room, frame.script, getOpcodeName(frame.opcode).c_str());
+		}
+		line += Common::String::format(" %u\n", value);
+		out.writeString(line);
+	}
+
+	out.flush();
+	return !out.err();
+}
+
+Common::String ScriptProfiler::getOpcodeName(byte opcode) const {
+	const char *desc = _vm->getOpcodeDesc(opcode);
+	if (desc && *desc)
+		return desc;
+	return Common::String::format("op_%02x", opcode);
+}
+
+} // End of namespace Scumm
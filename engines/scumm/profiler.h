@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_PROFILER_H
+#define SCUMM_PROFILER_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace Scumm {
+
+class ScummEngine;
+
+/**
+ * Opcode level profiler for the script interpreter.
+ *
+ * While enabled, every executed opcode is counted and timed, keyed by the
+ * room, the script number and the opcode, as well as by the chain of
+ * nested scripts (runScriptNested) which led to it. Times are self times,
+ * i.e. the time spent in nested scripts started by an opcode is accounted
+ * to those scripts, not to the opcode itself.
+ *
+ * Time is measured with OSystem::getMillis(). Most opcodes take far less
+ * than a millisecond, so individual samples are mostly 0 or 1; summed up
+ * over many executions this still gives a good estimate of where the time
+ * goes.
+ *
+ * The profiler is controlled with the "profile" debugger command. While it
+ * is disabled, its only cost is one flag test per executed opcode.
+ */
+class ScriptProfiler {
+public:
+	struct Entry {
+		int room;
+		int script;
+		byte opcode;
+		uint32 count;
+		uint32 time;
+	};
+
+	ScriptProfiler(ScummEngine *vm);
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enable);
+	void reset();
+
+	void beginOpcode(int room, int script, byte opcode);
+	void endOpcode();
+
+	Common::String getOpcodeName(byte opcode) const;
+
+	/** Total number of opcodes executed and milliseconds spent in them. */
+	void getTotals(uint32 &count, uint32 &time) const;
+
+	/**
+	 * Fill 'entries' with the statistics per room, script and opcode,
+	 * sorted by descending time (and count, for equal times).
+	 */
+	void getReport(Common::Array<Entry> &entries) const;
+
+	/**
+	 * Write the collected call stacks to 'filename' in the "folded" format
+	 * read by flame graph tools: one line per stack, with the frames
+	 * separated by semicolons, followed by the time in milliseconds (or
+	 * the execution count, if 'byCount' is set).
+	 */
+	bool dumpFoldedStacks(const Common::String &filename, bool byCount) const;
+
+private:
+	enum {
+		kMaxDepth = 64
+	};
+
+	struct Node {
+		uint32 parent;
+		int room;
+		int script;
+		byte opcode;
+		uint32 count;
+		uint32 time;
+	};
+
+	struct NodeKey {
+		uint32 parent;
+		int room;
+		int script;
+		byte opcode;
+	};
+
+	struct NodeKey_Hash {
+		uint operator()(const NodeKey &k) const {
+			return (k.parent * 31 + k.room) * 65599 + (k.script << 8) + k.opcode;
+		}
+	};
+
+	struct NodeKey_EqualTo {
+		bool operator()(const NodeKey &a, const NodeKey &b) const {
+			return a.parent == b.parent && a.room == b.room && a.script == b.script && a.opcode == b.opcode;
+		}
+	};
+
+	struct Frame {
+		uint32 node;
+		uint32 start;
+		uint32 childTime;
+	};
+
+	typedef Common::HashMap<NodeKey, uint32, NodeKey_Hash, NodeKey_EqualTo> NodeMap;
+
+	ScummEngine *_vm;
+	bool _enabled;
+
+	/** The call tree; node 0 is the root. */
+	Common::Array<Node> _nodes;
+	NodeMap _nodeMap;
+
+	Frame _stack[kMaxDepth];
+	int _depth;
+	int _overflow;
+};
+
+} // End of namespace Scumm
+
+#endif
@@ -894,6 +894,14 @@ bool ResourceManager::validateResource(const char *str, ResType type, ResId idx)
 
 void ResourceManager::nukeResource(ResType type, ResId idx) {
 	byte *ptr = _types[type][idx]._address;
+
+	// The walkbox data derived from the box resources (rtMatrix 2) is about
+	// to become stale, this also happens on every room change. Replacing
+	// the box matrix (rtMatrix 1), e.g. from createBoxMatrix(), doesn't
+	// affect the cached geometry and itinerary matrix.
+	if (type == rtMatrix)
+		_vm->invalidateBoxCache(idx == 2);
+
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
@@ -26,6 +26,7 @@
 
 #include "scumm/actor.h"
 #include "scumm/object.h"
+#include "scumm/profiler.h"
 #include "scumm/resource.h"
 #include "scumm/util.h"
 #include "scumm/scumm_v2.h"
@@ -480,8 +481,13 @@ void ScummEngine::executeScript() {
 			debugN("\n");
 		}
 
-		executeOpcode(_opcode);
-
+		if (_scriptProfiler->isEnabled()) {
+			_scriptProfiler->beginOpcode(_currentRoom, vm.slot[_currentScript].number, _opcode);
+			executeOpcode(_opcode);
+			_scriptProfiler->endOpcode();
+		} else {
+			executeOpcode(_opcode);
+		}
 	}
 }
 
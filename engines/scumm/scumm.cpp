@@ -61,6 +61,7 @@
 #include "scumm/player_v2a.h"
 #include "scumm/player_v3a.h"
 #include "scumm/player_v4a.h"
+#include "scumm/profiler.h"
 #include "scumm/resource.h"
 #include "scumm/he/resource_he.h"
 #include "scumm/scumm_v0.h"
@@ -135,6 +136,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_scriptProfiler = new ScriptProfiler(this);
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -640,6 +642,7 @@ ScummEngine::~ScummEngine() {
 #endif
 
 	delete _debugger;
+	delete _scriptProfiler;
 
 	delete _res;
 	delete _gdi;
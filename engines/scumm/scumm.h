@@ -36,6 +36,7 @@
 #include "graphics/surface.h"
 #include "graphics/sjis.h"
 
+#include "scumm/boxes.h"
 #include "scumm/gfx.h"
 #include "scumm/detection.h"
 #include "scumm/script.h"
@@ -86,11 +87,11 @@ class MusicEngine;
 class Player_Towns;
 class ScummEngine;
 class ScummDebugger;
+class ScriptProfiler;
 class Serializer;
 class Sound;
 
 struct Box;
-struct BoxCoords;
 struct FindObjectInRoom;
 
 // Use g_scumm from error() ONLY
@@ -344,6 +345,7 @@ class ResourceManager;
  */
 class ScummEngine : public Engine {
 	friend class ScummDebugger;
+	friend class ScriptProfiler;
 	friend class CharsetRenderer;
 	friend class CharsetRendererTownsClassic;
 	friend class ResourceManager;
@@ -361,6 +363,7 @@ public:
 	VerbSlot *_verbs;
 	ObjectData *_objs;
 	ScummDebugger *_debugger;
+	ScriptProfiler *_scriptProfiler;
 
 	// Core variables
 	GameSettings _game;
@@ -1104,6 +1107,13 @@ public:
 	byte getBoxFlags(int box);
 	int getBoxScale(int box);
 
+	/**
+	 * Drop the cached box data. If boxesChanged is false, only the box
+	 * matrix (rtMatrix 1) was replaced and the geometry and itinerary
+	 * matrix are kept.
+	 */
+	void invalidateBoxCache(bool boxesChanged);
+
 	int getScale(int box, int x, int y);
 	int getScaleFromSlot(int slot, int x, int y);
 
@@ -1118,6 +1128,11 @@ protected:
 	void setBoxScaleSlot(int box, int slot);
 	void convertScaleTableToScaleSlot(int slot);
 
+	BoxCache _boxCache;
+	const BoxCache &getBoxCache();
+	BoxCoords decodeBoxCoordinates(int boxnum);
+	const byte *getItineraryMatrix();
+
 	void calcItineraryMatrix(byte *itineraryMatrix, int num);
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbors(int i, int j);
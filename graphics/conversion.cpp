@@ -26,6 +26,138 @@ namespace Graphics {
 
 // TODO: YUV to RGB conversion function
 
+namespace {
+
+/**
+ * A pixel format known at compile time. The template arguments are the
+ * same as the ones of the PixelFormat constructor.
+ */
+template<int BytesPerPixel, int RBits, int GBits, int BBits, int ABits, int RShift, int GShift, int BShift, int AShift>
+struct ConstPixelFormat {
+	enum {
+		kBytesPerPixel = BytesPerPixel,
+		kRLoss = 8 - RBits, kGLoss = 8 - GBits, kBLoss = 8 - BBits, kALoss = 8 - ABits,
+		kRShift = RShift, kGShift = GShift, kBShift = BShift, kAShift = AShift
+	};
+};
+
+template<int BytesPerPixel> struct PixelType {};
+template<> struct PixelType<2> { typedef uint16 Type; };
+template<> struct PixelType<4> { typedef uint32 Type; };
+
+/**
+ * Same as srcFmt.colorToARGB() followed by dstFmt.ARGBToColor(), but
+ * since all shifts and losses are constants, the compiler reduces it to
+ * a few masks and shifts.
+ */
+template<class Src, class Dst>
+inline uint32 convertColor(uint32 color) {
+	return
+		(((((color >> Src::kAShift) << Src::kALoss) & 0xFF) >> Dst::kALoss) << Dst::kAShift) |
+		(((((color >> Src::kRShift) << Src::kRLoss) & 0xFF) >> Dst::kRLoss) << Dst::kRShift) |
+		(((((color >> Src::kGShift) << Src::kGLoss) & 0xFF) >> Dst::kGLoss) << Dst::kGShift) |
+		(((((color >> Src::kBShift) << Src::kBLoss) & 0xFF) >> Dst::kBLoss) << Dst::kBShift);
+}
+
+template<class Src, class Dst>
+void convertRect(byte *dst, const byte *src, int dstpitch, int srcpitch, int w, int h) {
+	typedef typename PixelType<Src::kBytesPerPixel>::Type SrcColor;
+	typedef typename PixelType<Dst::kBytesPerPixel>::Type DstColor;
+
+	for (int y = 0; y < h; y++) {
+		const SrcColor *s = (const SrcColor *)src;
+		DstColor *d = (DstColor *)dst;
+		for (int x = 0; x < w; x++)
+			d[x] = convertColor<Src, Dst>(s[x]);
+		src += srcpitch;
+		dst += dstpitch;
+	}
+}
+
+// The formats commonly used by engines, video decoders and backends
+#define FORMAT_RGB565   2, 5, 6, 5, 0, 11, 5, 0, 0
+#define FORMAT_BGR565   2, 5, 6, 5, 0, 0, 5, 11, 0
+#define FORMAT_XRGB1555 2, 5, 5, 5, 0, 10, 5, 0, 0
+#define FORMAT_ARGB1555 2, 5, 5, 5, 1, 10, 5, 0, 15
+#define FORMAT_RGBA8888 4, 8, 8, 8, 8, 24, 16, 8, 0
+#define FORMAT_ARGB8888 4, 8, 8, 8, 8, 16, 8, 0, 24
+#define FORMAT_ABGR8888 4, 8, 8, 8, 8, 0, 8, 16, 24
+#define FORMAT_BGRA8888 4, 8, 8, 8, 8, 8, 16, 24, 0
+#define FORMAT_XRGB8888 4, 8, 8, 8, 0, 16, 8, 0, 0
+
+typedef ConstPixelFormat<FORMAT_RGB565> FormatRGB565;
+typedef ConstPixelFormat<FORMAT_BGR565> FormatBGR565;
+typedef ConstPixelFormat<FORMAT_XRGB1555> FormatXRGB1555;
+typedef ConstPixelFormat<FORMAT_ARGB1555> FormatARGB1555;
+typedef ConstPixelFormat<FORMAT_RGBA8888> FormatRGBA8888;
+typedef ConstPixelFormat<FORMAT_ARGB8888> FormatARGB8888;
+typedef ConstPixelFormat<FORMAT_ABGR8888> FormatABGR8888;
+typedef ConstPixelFormat<FORMAT_BGRA8888> FormatBGRA8888;
+typedef ConstPixelFormat<FORMAT_XRGB8888> FormatXRGB8888;
+
+struct KnownFormat {
+	byte bytesPerPixel;
+	byte rBits, gBits, bBits, aBits;
+	byte rShift, gShift, bShift, aShift;
+};
+
+// Must be in the same order as the rows and columns of s_converters
+const KnownFormat s_knownFormats[] = {
+	{ FORMAT_RGB565 },
+	{ FORMAT_BGR565 },
+	{ FORMAT_XRGB1555 },
+	{ FORMAT_ARGB1555 },
+	{ FORMAT_RGBA8888 },
+	{ FORMAT_ARGB8888 },
+	{ FORMAT_ABGR8888 },
+	{ FORMAT_BGRA8888 },
+	{ FORMAT_XRGB8888 }
+};
+
+enum {
+	kNumKnownFormats = ARRAYSIZE(s_knownFormats)
+};
+
+typedef void (*ConvertProc)(byte *dst, const byte *src, int dstpitch, int srcpitch, int w, int h);
+
+#define CONVERTERS_TO_16BPP(src) \
+	convertRect<src, FormatRGB565>, convertRect<src, FormatBGR565>, \
+	convertRect<src, FormatXRGB1555>, convertRect<src, FormatARGB1555>
+#define CONVERTERS_TO_32BPP(src) \
+	convertRect<src, FormatRGBA8888>, convertRect<src, FormatARGB8888>, \
+	convertRect<src, FormatABGR8888>, convertRect<src, FormatBGRA8888>, \
+	convertRect<src, FormatXRGB8888>
+#define NO_CONVERTERS_TO_16BPP 0, 0, 0, 0
+
+// Indexed by source and destination format. Conversion to a format with
+// less bytes per pixel is not supported.
+const ConvertProc s_converters[kNumKnownFormats][kNumKnownFormats] = {
+	{ CONVERTERS_TO_16BPP(FormatRGB565), CONVERTERS_TO_32BPP(FormatRGB565) },
+	{ CONVERTERS_TO_16BPP(FormatBGR565), CONVERTERS_TO_32BPP(FormatBGR565) },
+	{ CONVERTERS_TO_16BPP(FormatXRGB1555), CONVERTERS_TO_32BPP(FormatXRGB1555) },
+	{ CONVERTERS_TO_16BPP(FormatARGB1555), CONVERTERS_TO_32BPP(FormatARGB1555) },
+	{ NO_CONVERTERS_TO_16BPP, CONVERTERS_TO_32BPP(FormatRGBA8888) },
+	{ NO_CONVERTERS_TO_16BPP, CONVERTERS_TO_32BPP(FormatARGB8888) },
+	{ NO_CONVERTERS_TO_16BPP, CONVERTERS_TO_32BPP(FormatABGR8888) },
+	{ NO_CONVERTERS_TO_16BPP, CONVERTERS_TO_32BPP(FormatBGRA8888) },
+	{ NO_CONVERTERS_TO_16BPP, CONVERTERS_TO_32BPP(FormatXRGB8888) }
+};
+
+#undef CONVERTERS_TO_16BPP
+#undef CONVERTERS_TO_32BPP
+#undef NO_CONVERTERS_TO_16BPP
+
+int findKnownFormat(const PixelFormat &fmt) {
+	for (int i = 0; i < kNumKnownFormats; i++) {
+		const KnownFormat &k = s_knownFormats[i];
+		if (fmt == PixelFormat(k.bytesPerPixel, k.rBits, k.gBits, k.bBits, k.aBits, k.rShift, k.gShift, k.bShift, k.aShift))
+			return i;
+	}
+	return -1;
+}
+
+} // End of anonymous namespace
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src, int dstpitch, int srcpitch,
 						int w, int h, const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
@@ -52,12 +184,19 @@ bool crossBlit(byte *dst, const byte *src, int dstpitch, int srcpitch,
 		}
 	}
 
-	// Faster, but larger, to provide optimized handling for each case.
+	// Use a specialized converter for the common formats
+	const int srcIndex = findKnownFormat(srcFmt);
+	const int dstIndex = findKnownFormat(dstFmt);
+	if (srcIndex >= 0 && dstIndex >= 0 && s_converters[srcIndex][dstIndex]) {
+		s_converters[srcIndex][dstIndex](dst, src, dstpitch, srcpitch, w, h);
+		return true;
+	}
+
+	// Any other formats go through the generic code below
 	int srcDelta, dstDelta;
 	srcDelta = (srcpitch - w * srcFmt.bytesPerPixel);
 	dstDelta = (dstpitch - w * dstFmt.bytesPerPixel);
 
-	// TODO: optimized cases for dstDelta of 0
 	uint8 r, g, b, a;
 	if (dstFmt.bytesPerPixel == 2) {
 		uint16 color;
@@ -119,7 +258,7 @@ bool crossBlit(byte *dst, const byte *src, int dstpitch, int srcpitch,
 			col++;
 #endif
 			for (int y = 0; y < h; y++) {
-				for (int x = 0; x < w; x++, src += 2, dst += 4) {
+				for (int x = 0; x < w; x++, src += 3, dst += 4) {
 					memcpy(col, src, 3);
 					srcFmt.colorToARGB(color, a, r, g, b);
 					color = dstFmt.ARGBToColor(a, r, g, b);
@@ -43,20 +43,25 @@ static const uint8 _zigZagOrder[64] = {
 	53, 60, 61, 54, 47, 55, 62, 63
 };
 
-// IDCT table built with :
-// _idct8x8[x][y] = cos(((2 * x + 1) * y) * (M_PI / 16.0)) * 0.5;
-// _idct8x8[x][y] /= sqrt(2.0) if y == 0
-static const double _idct8x8[8][8] = {
-	{ 0.353553390593274,  0.490392640201615,  0.461939766255643,  0.415734806151273,  0.353553390593274,  0.277785116509801,  0.191341716182545,  0.097545161008064 },
-	{ 0.353553390593274,  0.415734806151273,  0.191341716182545, -0.097545161008064, -0.353553390593274, -0.490392640201615, -0.461939766255643, -0.277785116509801 },
-	{ 0.353553390593274,  0.277785116509801, -0.191341716182545, -0.490392640201615, -0.353553390593274,  0.097545161008064,  0.461939766255643,  0.415734806151273 },
-	{ 0.353553390593274,  0.097545161008064, -0.461939766255643, -0.277785116509801,  0.353553390593274,  0.415734806151273, -0.191341716182545, -0.490392640201615 },
-	{ 0.353553390593274, -0.097545161008064, -0.461939766255643,  0.277785116509801,  0.353553390593274, -0.415734806151273, -0.191341716182545,  0.490392640201615 },
-	{ 0.353553390593274, -0.277785116509801, -0.191341716182545,  0.490392640201615, -0.353553390593273, -0.097545161008064,  0.461939766255643, -0.415734806151273 },
-	{ 0.353553390593274, -0.415734806151273,  0.191341716182545,  0.097545161008064, -0.353553390593274,  0.490392640201615, -0.461939766255643,  0.277785116509801 },
-	{ 0.353553390593274, -0.490392640201615,  0.461939766255643, -0.415734806151273,  0.353553390593273, -0.277785116509801,  0.191341716182545, -0.097545161008064 }
+// Fixed point constants of the IDCT, scaled by 2^13 (see idct8x8)
+enum {
+	kIDCTConstBits = 13,
+	kIDCTPass1Bits = 2
 };
 
+#define FIX_0_298631336  2446
+#define FIX_0_390180644  3196
+#define FIX_0_541196100  4433
+#define FIX_0_765366865  6270
+#define FIX_0_899976223  7373
+#define FIX_1_175875602  9633
+#define FIX_1_501321110 12299
+#define FIX_1_847759065 15137
+#define FIX_1_961570560 16069
+#define FIX_2_053119869 16819
+#define FIX_2_562915447 20995
+#define FIX_3_072711026 25172
+
 JPEG::JPEG() :
 	_stream(NULL), _w(0), _h(0), _numComp(0), _components(NULL), _numScanComp(0),
 	_scanComp(NULL), _currentComp(NULL) {
@@ -71,6 +76,7 @@ JPEG::JPEG() :
 		_huff[i].values = NULL;
 		_huff[i].sizes = NULL;
 		_huff[i].codes = NULL;
+		memset(_huff[i].lookup, 0, sizeof(_huff[i].lookup));
 	}
 }
 
@@ -87,26 +93,50 @@ Surface *JPEG::getSurface(const PixelFormat &format) {
 	if (format.bytesPerPixel == 1)
 		return 0;
 
+	Graphics::Surface *output = new Graphics::Surface();
+	output->create(_w, _h, format);
+
+	convertToSurface(*output);
+
+	return output;
+}
+
+template<typename PixelInt>
+static void convertYUVToRGB(Surface &output, const Surface &y, const Surface &u, const Surface &v) {
+	const PixelFormat &format = output.format;
+
+	for (uint16 i = 0; i < output.h; i++) {
+		const byte *ySrc = (const byte *)y.getBasePtr(0, i);
+		const byte *uSrc = (const byte *)u.getBasePtr(0, i);
+		const byte *vSrc = (const byte *)v.getBasePtr(0, i);
+		PixelInt *dst = (PixelInt *)output.getBasePtr(0, i);
+
+		for (uint16 j = 0; j < output.w; j++) {
+			byte r, g, b;
+			YUV2RGB(ySrc[j], uSrc[j], vSrc[j], r, g, b);
+			dst[j] = format.RGBToColor(r, g, b);
+		}
+	}
+}
+
+bool JPEG::convertToSurface(Surface &output) {
+	// Make sure we have loaded data, and a matching surface
+	if (!isLoaded() || output.w != _w || output.h != _h)
+		return false;
+
 	// Get our component surfaces
 	Graphics::Surface *yComponent = getComponent(1);
 	Graphics::Surface *uComponent = getComponent(2);
 	Graphics::Surface *vComponent = getComponent(3);
 
-	Graphics::Surface *output = new Graphics::Surface();
-	output->create(yComponent->w, yComponent->h, format);
-
-	for (uint16 i = 0; i < output->h; i++) {
-		for (uint16 j = 0; j < output->w; j++) {
-			byte r = 0, g = 0, b = 0;
-			YUV2RGB(*((byte *)yComponent->getBasePtr(j, i)), *((byte *)uComponent->getBasePtr(j, i)), *((byte *)vComponent->getBasePtr(j, i)), r, g, b);
-			if (format.bytesPerPixel == 2)
-				*((uint16 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-			else
-				*((uint32 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-		}
-	}
+	if (output.format.bytesPerPixel == 2)
+		convertYUVToRGB<uint16>(output, *yComponent, *uComponent, *vComponent);
+	else if (output.format.bytesPerPixel == 4)
+		convertYUVToRGB<uint32>(output, *yComponent, *uComponent, *vComponent);
+	else
+		return false;
 
-	return output;
+	return true;
 }
 
 void JPEG::reset() {
@@ -137,6 +167,7 @@ void JPEG::reset() {
 		delete[] _huff[i].values; _huff[i].values = NULL;
 		delete[] _huff[i].sizes; _huff[i].sizes = NULL;
 		delete[] _huff[i].codes; _huff[i].codes = NULL;
+		memset(_huff[i].lookup, 0, sizeof(_huff[i].lookup));
 	}
 }
 
@@ -345,6 +376,20 @@ bool JPEG::readDHT() {
 			curCode++;
 			cur++;
 		}
+
+		// Fill the lookup table with the short codes: every entry starting
+		// with a code points to it
+		memset(_huff[tableNum].lookup, 0, sizeof(_huff[tableNum].lookup));
+		for (cur = 0; cur < _huff[tableNum].count; cur++) {
+			uint8 codeSize = _huff[tableNum].sizes[cur];
+			if (codeSize > kHuffLookupBits)
+				break;
+
+			uint16 first = _huff[tableNum].codes[cur] << (kHuffLookupBits - codeSize);
+			uint16 last = first + (1 << (kHuffLookupBits - codeSize));
+			for (uint16 i = first; i < last; i++)
+				_huff[tableNum].lookup[i] = (codeSize << 8) | _huff[tableNum].values[cur];
+		}
 	}
 
 	return true;
@@ -427,7 +472,9 @@ bool JPEG::readSOS() {
 	}
 
 	// Entropy coded sequence starts, initialize Huffman decoder
+	_bitsData = 0;
 	_bitsNumber = 0;
+	_bitsMarker = false;
 
 	// Read all the scan MCUs
 	uint16 xMCU = _w / (_maxFactorH * 8);
@@ -504,38 +551,144 @@ bool JPEG::readMCU(uint16 xMCU, uint16 yMCU) {
 	return ok;
 }
 
-void JPEG::idct8x8(float result[64], const int16 dct[64]) {
-	float tmp[64];
+// The islow IDCT of the IJG's libjpeg, which is based on the algorithm of
+// Loeffler, Ligtenberg and Moschytz: separable 1D IDCTs on the columns and
+// then the rows, with 13 bit fixed point constants. The result is level
+// shifted and clipped into 0..255, rounding down like the float IDCT did.
+void JPEG::idct8x8(byte result[64], const int16 dct[64]) {
+	int32 tmp[64];
 
-	// Apply 1D IDCT to rows
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			tmp[y + x * 8] = dct[0] * _idct8x8[x][0]
-							+ dct[1] * _idct8x8[x][1]
-							+ dct[2] * _idct8x8[x][2]
-							+ dct[3] * _idct8x8[x][3]
-							+ dct[4] * _idct8x8[x][4]
-							+ dct[5] * _idct8x8[x][5]
-							+ dct[6] * _idct8x8[x][6]
-							+ dct[7] * _idct8x8[x][7];
+	// Apply 1D IDCT to columns, scaling up by kIDCTPass1Bits
+	for (int x = 0; x < 8; x++) {
+		const int16 *in = dct + x;
+		int32 *out = tmp + x;
+
+		// Columns with only a DC coefficient are common
+		if ((in[8] | in[16] | in[24] | in[32] | in[40] | in[48] | in[56]) == 0) {
+			int32 dc = in[0] << kIDCTPass1Bits;
+			out[0] = out[8] = out[16] = out[24] = out[32] = out[40] = out[48] = out[56] = dc;
+			continue;
 		}
 
-		dct += 8;
+		// Even part
+		int32 z2 = in[16];
+		int32 z3 = in[48];
+
+		int32 z1 = (z2 + z3) * FIX_0_541196100;
+		int32 tmp2 = z1 + z3 * (-FIX_1_847759065);
+		int32 tmp3 = z1 + z2 * FIX_0_765366865;
+
+		int32 tmp0 = (in[0] + in[32]) << kIDCTConstBits;
+		int32 tmp1 = (in[0] - in[32]) << kIDCTConstBits;
+
+		int32 tmp10 = tmp0 + tmp3;
+		int32 tmp13 = tmp0 - tmp3;
+		int32 tmp11 = tmp1 + tmp2;
+		int32 tmp12 = tmp1 - tmp2;
+
+		// Odd part
+		tmp0 = in[56];
+		tmp1 = in[40];
+		tmp2 = in[24];
+		tmp3 = in[8];
+
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int32 z4 = tmp1 + tmp3;
+		int32 z5 = (z3 + z4) * FIX_1_175875602;
+
+		tmp0 *= FIX_0_298631336;
+		tmp1 *= FIX_2_053119869;
+		tmp2 *= FIX_3_072711026;
+		tmp3 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 *= -FIX_1_961570560;
+		z4 *= -FIX_0_390180644;
+
+		z3 += z5;
+		z4 += z5;
+
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		const int shift = kIDCTConstBits - kIDCTPass1Bits;
+		const int32 round = 1 << (shift - 1);
+		out[ 0] = (tmp10 + tmp3 + round) >> shift;
+		out[56] = (tmp10 - tmp3 + round) >> shift;
+		out[ 8] = (tmp11 + tmp2 + round) >> shift;
+		out[48] = (tmp11 - tmp2 + round) >> shift;
+		out[16] = (tmp12 + tmp1 + round) >> shift;
+		out[40] = (tmp12 - tmp1 + round) >> shift;
+		out[24] = (tmp13 + tmp0 + round) >> shift;
+		out[32] = (tmp13 - tmp0 + round) >> shift;
 	}
 
-	// Apply 1D IDCT to columns
-	for (int x = 0; x < 8; x++) {
-		const float *u = tmp + x * 8;
-		for (int y = 0; y < 8; y++) {
-			result[y * 8 + x] = u[0] * _idct8x8[y][0]
-								+ u[1] * _idct8x8[y][1]
-								+ u[2] * _idct8x8[y][2]
-								+ u[3] * _idct8x8[y][3]
-								+ u[4] * _idct8x8[y][4]
-								+ u[5] * _idct8x8[y][5]
-								+ u[6] * _idct8x8[y][6]
-								+ u[7] * _idct8x8[y][7];
-		}
+	// Apply 1D IDCT to rows, scaling down by kIDCTPass1Bits and the 8 of the
+	// two 1D IDCTs
+	for (int y = 0; y < 8; y++) {
+		const int32 *in = tmp + y * 8;
+		byte *out = result + y * 8;
+
+		const int shift = kIDCTConstBits + kIDCTPass1Bits + 3;
+
+		// Even part
+		int32 z2 = in[2];
+		int32 z3 = in[6];
+
+		int32 z1 = (z2 + z3) * FIX_0_541196100;
+		int32 tmp2 = z1 + z3 * (-FIX_1_847759065);
+		int32 tmp3 = z1 + z2 * FIX_0_765366865;
+
+		// Level shift to make the values unsigned
+		int32 tmp0 = ((in[0] + in[4]) << kIDCTConstBits) + (128 << shift);
+		int32 tmp1 = ((in[0] - in[4]) << kIDCTConstBits) + (128 << shift);
+
+		int32 tmp10 = tmp0 + tmp3;
+		int32 tmp13 = tmp0 - tmp3;
+		int32 tmp11 = tmp1 + tmp2;
+		int32 tmp12 = tmp1 - tmp2;
+
+		// Odd part
+		tmp0 = in[7];
+		tmp1 = in[5];
+		tmp2 = in[3];
+		tmp3 = in[1];
+
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int32 z4 = tmp1 + tmp3;
+		int32 z5 = (z3 + z4) * FIX_1_175875602;
+
+		tmp0 *= FIX_0_298631336;
+		tmp1 *= FIX_2_053119869;
+		tmp2 *= FIX_3_072711026;
+		tmp3 *= FIX_1_501321110;
+		z1 *= -FIX_0_899976223;
+		z2 *= -FIX_2_562915447;
+		z3 *= -FIX_1_961570560;
+		z4 *= -FIX_0_390180644;
+
+		z3 += z5;
+		z4 += z5;
+
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		out[0] = CLIP<int32>((tmp10 + tmp3) >> shift, 0, 255);
+		out[7] = CLIP<int32>((tmp10 - tmp3) >> shift, 0, 255);
+		out[1] = CLIP<int32>((tmp11 + tmp2) >> shift, 0, 255);
+		out[6] = CLIP<int32>((tmp11 - tmp2) >> shift, 0, 255);
+		out[2] = CLIP<int32>((tmp12 + tmp1) >> shift, 0, 255);
+		out[5] = CLIP<int32>((tmp12 - tmp1) >> shift, 0, 255);
+		out[3] = CLIP<int32>((tmp13 + tmp0) >> shift, 0, 255);
+		out[4] = CLIP<int32>((tmp13 - tmp0) >> shift, 0, 255);
 	}
 }
 
@@ -565,20 +718,9 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	}
 
 	// Apply the IDCT
-	float result[64];
+	byte result[64];
 	idct8x8(result, DCT);
 
-	// Level shift to make the values unsigned
-	for (int i = 0; i < 64; i++) {
-		result[i] = result[i] + 128;
-
-		if (result[i] < 0)
-			result[i] = 0;
-
-		if (result[i] > 255)
-			result[i] = 255;
-	}
-
 	// Paint the component surface
 	uint8 scalingV = _maxFactorV / _currentComp->factorV;
 	uint8 scalingH = _maxFactorH / _currentComp->factorH;
@@ -587,6 +729,14 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	x <<= 3;
 	y <<= 3;
 
+	// Components without subsampling are the common case
+	if (scalingV == 1 && scalingH == 1) {
+		for (uint8 j = 0; j < 8; j++)
+			memcpy(_currentComp->surface.getBasePtr(x, y + j), result + j * 8, 8);
+
+		return true;
+	}
+
 	for (uint8 j = 0; j < 8; j++) {
 		for (uint16 sV = 0; sV < scalingV; sV++) {
 			// Get the beginning of the block line
@@ -594,7 +744,7 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 
 			for (uint8 i = 0; i < 8; i++) {
 				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(result[j * 8 + i]);
+					*ptr = result[j * 8 + i];
 					ptr++;
 				}
 			}
@@ -646,12 +796,14 @@ void JPEG::readAC(int16 *out) {
 }
 
 int16 JPEG::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
 	if (numBits > 16) error("requested %d bits", numBits); //XXX
 
+	if (numBits == 0)
+		return 0;
+
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	uint16 ret = peekBits(numBits);
+	skipBits(numBits);
 
 	// Extend sign bits (PAG109)
 	if (!(ret >> (numBits - 1)))
@@ -662,8 +814,15 @@ int16 JPEG::readSignedBits(uint8 numBits) {
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEG::readHuff(uint8 table) {
+	// Short codes are found in the lookup table
+	uint16 entry = _huff[table].lookup[peekBits(kHuffLookupBits)];
+	if (entry) {
+		skipBits(entry >> 8);
+		return entry & 0xFF;
+	}
+
+	// Search the longer ones
 	bool foundCode = false;
 	uint8 val = 0;
 
@@ -693,31 +852,48 @@ uint8 JPEG::readHuff(uint8 table) {
 	return val;
 }
 
-uint8 JPEG::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _stream->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _stream->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					warning("DNL marker detected: terminate scan");
-				} else {
-					warning("Error: marker 0x%02X read in entropy data", byte2);
+void JPEG::fillBits() {
+	// Keep at least 16 bits around, enough for any code or value. Reading
+	// ahead stops at the marker following the entropy coded data, so
+	// read() continues right there afterwards.
+	while (_bitsNumber <= 24) {
+		uint8 data = 0;
+
+		if (!_bitsMarker) {
+			data = _stream->readByte();
+
+			// Detect markers
+			if (data == 0xFF) {
+				uint8 byte2 = _stream->readByte();
+
+				// A stuffed 0 validates the previous byte
+				if (byte2 != 0) {
+					if (byte2 == 0xDC) {
+						// DNL marker: Define Number of Lines
+						// TODO: terminate scan
+						warning("DNL marker detected: terminate scan");
+					} else if (byte2 != 0xD9) {
+						warning("Error: marker 0x%02X read in entropy data", byte2);
+					}
+
+					// Leave the marker for read(), and pad the entropy
+					// data with zeros from here on
+					_stream->seek(-2, SEEK_CUR);
+					_bitsMarker = true;
+					data = 0;
 				}
 			}
 		}
+
+		_bitsData = (_bitsData << 8) | data;
+		_bitsNumber += 8;
 	}
-	_bitsNumber--;
+}
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+uint8 JPEG::readBit() {
+	uint8 bit = peekBits(1);
+	skipBits(1);
+	return bit;
 }
 
 Surface *JPEG::getComponent(uint c) {
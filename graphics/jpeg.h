@@ -49,6 +49,13 @@ public:
 	Surface *getComponent(uint c);
 	Surface *getSurface(const PixelFormat &format);
 
+	/**
+	 * Convert the image into an existing >8bpp surface of the image's size.
+	 * Unlike getSurface(), this doesn't allocate anything, so e.g. a video
+	 * decoder can reuse its surface for every frame.
+	 */
+	bool convertToSurface(Surface &output);
+
 private:
 	void reset();
 
@@ -88,11 +95,20 @@ private:
 	uint16 *_quant[JPEG_MAX_QUANT_TABLES];
 
 	// Huffman tables
+	enum {
+		// Codes up to this size are found with a single table lookup
+		kHuffLookupBits = 9
+	};
+
 	struct HuffmanTable {
 		uint8 count;
 		uint8 *values;
 		uint8 *sizes;
 		uint16 *codes;
+
+		// Code size << 8 | value, indexed by the next kHuffLookupBits bits,
+		// or 0 for longer codes
+		uint16 lookup[1 << kHuffLookupBits];
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
 
 	// Marker read functions
@@ -112,11 +128,19 @@ private:
 	// Huffman decoding
 	uint8 readHuff(uint8 table);
 	uint8 readBit();
-	uint8 _bitsData;
+	void fillBits();
+	uint16 peekBits(uint8 numBits) {
+		if (_bitsNumber < numBits)
+			fillBits();
+		return (_bitsData >> (_bitsNumber - numBits)) & ((1 << numBits) - 1);
+	}
+	void skipBits(uint8 numBits) { _bitsNumber -= numBits; }
+	uint32 _bitsData;
 	uint8 _bitsNumber;
+	bool _bitsMarker;
 
 	// Inverse Discrete Cosine Transformation
-	void idct8x8(float dst[64], const int16 src[64]);
+	void idct8x8(byte dst[64], const int16 src[64]);
 };
 
 } // End of Graphics namespace
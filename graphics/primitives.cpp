@@ -20,6 +20,7 @@
  */
 
 #include "common/util.h"
+#include "graphics/primitives.h"
 
 namespace Graphics {
 
@@ -116,4 +117,101 @@ void drawThickLine(int x0, int y0, int x1, int y1, int thickness, int color, voi
 	}
 }
 
+FloodFill::FloodFill(uint stackSize) : _pixels(0), _pitch(0), _matchValue(0), _value(0) {
+	_stack.reserve(stackSize);
+}
+
+void FloodFill::pushSpan(int y, int x1, int x2, int dy) {
+	// Only queue spans whose next line lies within the bounds
+	if (y + dy < _bounds.top || y + dy >= _bounds.bottom)
+		return;
+
+	Span span;
+	span.y = y;
+	span.x1 = x1;
+	span.x2 = x2;
+	span.dy = dy;
+	_stack.push_back(span);
+}
+
+void FloodFill::paintSpan(int x1, int x2, int y) {
+	memset(_pixels + y * _pitch + x1, _value, x2 - x1 + 1);
+
+	const Common::Rect r(x1, y, x2 + 1, y + 1);
+	if (_filledRect.isEmpty())
+		_filledRect = r;
+	else
+		_filledRect.extend(r);
+}
+
+bool FloodFill::fill(byte *pixels, int pitch, int x, int y, byte value) {
+	// This is the span based seed fill by Paul Heckbert, from Graphics Gems.
+	// Each stack entry is a span of line y which has been filled already,
+	// together with the direction of the line that still has to be looked at.
+	_filledRect = Common::Rect();
+
+	if (!_bounds.contains(x, y))
+		return false;
+
+	_pixels = pixels;
+	_pitch = pitch;
+	_matchValue = pixels[y * pitch + x];
+	_value = value;
+
+	// Filled pixels must no longer match, or the fill would never end
+	if (_matchValue == value)
+		return false;
+
+	const int left = _bounds.left;
+	const int right = _bounds.right - 1;
+
+	_stack.resize(0);
+	pushSpan(y, x, x, 1);
+	pushSpan(y + 1, x, x, -1);
+
+	while (!_stack.empty()) {
+		const Span span = _stack.back();
+		_stack.pop_back();
+
+		const int dy = span.dy;
+		const int x1 = span.x1;
+		const int x2 = span.x2;
+		y = span.y + dy;
+
+		x = x1;
+		while (x <= x2) {
+			if (!isMatch(x, y)) {
+				x++;
+				continue;
+			}
+
+			// Found a run of matching pixels. Only a run starting at x1 can
+			// extend to the left of the parent span.
+			int start = x;
+			if (x == x1) {
+				while (start > left && isMatch(start - 1, y))
+					start--;
+			}
+			int end = x;
+			while (end < right && isMatch(end + 1, y))
+				end++;
+
+			paintSpan(start, end, y);
+			pushSpan(y, start, end, dy);
+
+			// Parts sticking out of the parent span may leak back around
+			// the edges, so look at the previous line there as well
+			if (start < x1)
+				pushSpan(y, start, x1 - 1, -dy);
+			if (end > x2)
+				pushSpan(y, x2 + 1, end, -dy);
+
+			// end + 1 does not match, so skip it
+			x = end + 2;
+		}
+	}
+
+	return !_filledRect.isEmpty();
+}
+
 }	// End of namespace Graphics
@@ -22,11 +22,65 @@
 #ifndef GRAPHICS_PRIMITIVES_H
 #define GRAPHICS_PRIMITIVES_H
 
+#include "common/array.h"
+#include "common/rect.h"
+
 namespace Graphics {
 
 void drawLine(int x0, int y0, int x1, int y1, int color, void (*plotProc)(int, int, int, void *), void *data);
 void drawThickLine(int x0, int y0, int x1, int y1, int thickness, int color, void (*plotProc)(int, int, int, void *), void *data);
 
+/**
+ * Scanline flood fill for 8bpp buffers.
+ *
+ * The region to fill is the 4-connected area of pixels around the seed point
+ * which have the same value as the seed. It is painted one horizontal span at
+ * a time.
+ *
+ * Pending spans are kept on a stack that is allocated once and reused by
+ * subsequent fills, so filling large pictures does not allocate per pixel.
+ */
+class FloodFill {
+public:
+	/**
+	 * @param stackSize	initial number of pending spans to reserve room for,
+	 *			twice the buffer height is plenty for most shapes
+	 */
+	FloodFill(uint stackSize = 400);
+
+	/** Restrict the fill to the given rectangle. */
+	void setBounds(const Common::Rect &bounds) { _bounds = bounds; }
+
+	/**
+	 * Fill the region around (x, y) with value. Nothing is filled if the
+	 * seed lies outside the bounds or already has the given value.
+	 * @return true if any pixels were filled
+	 */
+	bool fill(byte *pixels, int pitch, int x, int y, byte value);
+
+	/** The area touched by the last fill. */
+	const Common::Rect &getFilledRect() const { return _filledRect; }
+
+private:
+	struct Span {
+		int16 y, x1, x2, dy;
+	};
+
+	bool isMatch(int x, int y) const { return _pixels[y * _pitch + x] == _matchValue; }
+	void pushSpan(int y, int x1, int x2, int dy);
+	void paintSpan(int x1, int x2, int y);
+
+	Common::Rect _bounds;
+	Common::Rect _filledRect;
+
+	byte *_pixels;
+	int _pitch;
+	byte _matchValue;
+	byte _value;
+
+	Common::Array<Span> _stack;
+};
+
 }	// End of namespace Graphics
 
 #endif
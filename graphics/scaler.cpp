@@ -20,6 +20,7 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 #include "graphics/scaler/scalebit.h"
 #include "common/util.h"
@@ -28,11 +29,10 @@
 
 int gBitFormat = 565;
 
-#ifdef USE_HQ_SCALERS
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
 // RGB-to-YUV lookup table
 extern "C" {
 
-#ifdef USE_NASM
 // NOTE: if your compiler uses different mangled names, add another
 //       condition here
 
@@ -55,28 +55,13 @@ uint32 hqx_greenMask = 0;
 uint32 hqx_redBlueMask = 0;
 uint32 hqx_green_redBlue_Mask = 0;
 
-#endif
-
 /**
  * 16bit RGB to YUV conversion table. This table is setup by InitLUT().
- * Used by the hq scaler family.
+ * Only used by the assembly versions of the hq scaler family, the C versions
+ * compute the YUV values on the fly, see convertToYUV().
  *
  * FIXME/TODO: The RGBtoYUV table sucks up 256 KB. This is bad.
  * In addition we never free it...
- *
- * Note: a memory lookup table is *not* necessarily faster than computing
- * these things on the fly, because of its size. The table together with
- * the code, plus the input/output GFX data, may not fit in the cache on some
- * systems, so main memory has to be accessed, which is about the worst thing
- * that can happen to code which tries to be fast...
- *
- * So we should think about ways to get this smaller / removed. Maybe we can
- * use the same technique employed by our MPEG code to reduce the size of the
- * lookup table at the cost of some additional computations?
- *
- * Of course, the above is largely a conjecture, and the actual speed
- * differences are likely to vary a lot between different architectures and
- * CPUs.
  */
 uint32 *RGBtoYUV = 0;
 }
@@ -102,7 +87,6 @@ void InitLUT(Graphics::PixelFormat format) {
 		RGBtoYUV[color] = (Y << 16) | (u << 8) | v;
 	}
 
-#ifdef USE_NASM
 	hqx_lowbits  = (1 << format.rShift) | (1 << format.gShift) | (1 << format.bShift),
 	hqx_low2bits = (3 << format.rShift) | (3 << format.gShift) | (3 << format.bShift),
 	hqx_low3bits = (7 << format.rShift) | (7 << format.gShift) | (7 << format.bShift),
@@ -115,7 +99,6 @@ void InitLUT(Graphics::PixelFormat format) {
 	hqx_redBlueMask = format.RGBToColor(255,0,255);
 
 	hqx_green_redBlue_Mask = (hqx_greenMask << 16) | hqx_redBlueMask;
-#endif
 }
 #endif
 
@@ -140,7 +123,7 @@ void InitScalers(uint32 BitFormat) {
 		format = g_system->getOverlayFormat();
 	}
 
-#ifdef USE_HQ_SCALERS
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
 	InitLUT(format);
 #endif
 
@@ -153,12 +136,88 @@ void InitScalers(uint32 BitFormat) {
 }
 
 void DestroyScalers(){
-#ifdef USE_HQ_SCALERS
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
 	free(RGBtoYUV);
 	RGBtoYUV = 0;
 #endif
 }
 
+static const ScalerInfo s_scalers[] = {
+	// name, description, implementation, proc, factor, border, reentrant, cpuFeatures
+	{ "1x", "Normal (no scaling)", "C", Normal1x, 1, 0, true, 0 },
+#ifdef USE_SCALERS
+#ifdef USE_ARM_SCALER_ASM
+	{ "2x", "2x", "ARM assembly", Normal2x, 2, 0, true, 0 },
+#else
+	{ "2x", "2x", "C", Normal2x, 2, 0, true, 0 },
+#endif
+	{ "3x", "3x", "C", Normal3x, 3, 0, true, 0 },
+	{ "2xsai", "2xSAI", "C", _2xSaI, 2, 2, true, 0 },
+	{ "super2xsai", "Super2xSAI", "C", Super2xSaI, 2, 2, true, 0 },
+	{ "supereagle", "SuperEagle", "C", SuperEagle, 2, 2, true, 0 },
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	{ "advmame2x", "AdvMAME2x", "MMX", AdvMame2x, 2, 1, true, 0 },
+#elif defined(USE_ARM_SCALER_ASM)
+	{ "advmame2x", "AdvMAME2x", "ARM assembly", AdvMame2x, 2, 1, true, 0 },
+#else
+	{ "advmame2x", "AdvMAME2x", "C", AdvMame2x, 2, 1, true, 0 },
+#endif
+	{ "advmame3x", "AdvMAME3x", "C", AdvMame3x, 3, 1, true, 0 },
+#ifdef USE_HQ_SCALERS
+#ifdef USE_NASM
+	{ "hq2x", "HQ2x", "i386 MMX", HQ2xMMX, 2, 1, false, kScalerCPUMMX },
+#endif
+	{ "hq2x", "HQ2x", "C", HQ2xC, 2, 1, true, 0 },
+#ifdef USE_NASM
+	{ "hq3x", "HQ3x", "i386 MMX", HQ3xMMX, 3, 1, false, kScalerCPUMMX },
+#endif
+	{ "hq3x", "HQ3x", "C", HQ3xC, 3, 1, true, 0 },
+#endif
+	{ "tv2x", "TV2x", "C", TV2x, 2, 0, true, 0 },
+	{ "dotmatrix", "DotMatrix", "C", DotMatrix, 2, 0, true, 0 },
+#endif
+	{ 0, 0, 0, 0, 0, 0, false, 0 }
+};
+
+const ScalerInfo *getScalerImplementations() {
+	return s_scalers;
+}
+
+uint32 getScalerCPUFeatures() {
+	static int features = -1;
+	if (features >= 0)
+		return features;
+
+	features = 0;
+#if defined(USE_NASM) && defined(__GNUC__) && defined(__i386__)
+	// CPUID function 1 reports MMX in bit 23 of edx. ebx is saved by hand,
+	// since it may be the PIC register.
+	uint32 eax, ebx, ecx, edx;
+	__asm__ __volatile__(
+		"xchgl %%ebx, %1\n\t"
+		"cpuid\n\t"
+		"xchgl %%ebx, %1"
+		: "=a" (eax), "=r" (ebx), "=c" (ecx), "=d" (edx)
+		: "0" (1));
+	if (edx & (1 << 23))
+		features |= kScalerCPUMMX;
+#elif defined(USE_NASM)
+	// Every CPU this can be built for with other compilers has MMX
+	features |= kScalerCPUMMX;
+#endif
+	return features;
+}
+
+const ScalerInfo *findScaler(const char *name) {
+	const uint32 features = getScalerCPUFeatures();
+
+	for (const ScalerInfo *info = s_scalers; info->name; ++info) {
+		if (!scumm_stricmp(info->name, name) && (info->cpuFeatures & ~features) == 0)
+			return info;
+	}
+	return 0;
+}
+
 
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -55,12 +55,71 @@ DECLARE_SCALER(TV2x);
 DECLARE_SCALER(DotMatrix);
 
 #ifdef USE_HQ_SCALERS
+// These use the assembly versions below when they are available for the
+// CPU, and the C versions otherwise.
 DECLARE_SCALER(HQ2x);
 DECLARE_SCALER(HQ3x);
+
+DECLARE_SCALER(HQ2xC);
+DECLARE_SCALER(HQ3xC);
+
+#ifdef USE_NASM
+// Assembly versions of the HQ scalers. They need a CPU with MMX, and keep
+// their state in global variables, so they must not run in several threads
+// at the same time.
+DECLARE_SCALER(HQ2xMMX);
+DECLARE_SCALER(HQ3xMMX);
+#endif
 #endif
 
 #endif // #ifdef USE_SCALERS
 
+/** CPU features a scaler implementation may require */
+enum {
+	kScalerCPUMMX = 1 << 0
+};
+
+/**
+ * Description of a scaler implementation. All scalers work on 16 bit
+ * pixels, in the 555 or 565 format passed to InitScalers().
+ */
+struct ScalerInfo {
+	/** Name of the scaler, as used for the gfx_mode config option */
+	const char *name;
+	/** Human readable name of the scaler */
+	const char *description;
+	/** Human readable name of the implementation, e.g. "C" or "i386 MMX" */
+	const char *implementation;
+	ScalerProc *proc;
+	/** Scale factor */
+	int factor;
+	/** Number of pixels around the source rect which the scaler reads */
+	int border;
+	/** Whether the scaler may run in several threads at the same time */
+	bool reentrant;
+	/** CPU features the implementation needs, see kScalerCPUMMX */
+	uint32 cpuFeatures;
+};
+
+/**
+ * Get all scaler implementations which were compiled in, including those
+ * which can not run on this CPU. Scalers with several implementations are
+ * listed several times, the best implementation first. The list ends with
+ * an entry with name 0.
+ */
+extern const ScalerInfo *getScalerImplementations();
+
+/** Get the CPU features of the running CPU, see kScalerCPUMMX. */
+extern uint32 getScalerCPUFeatures();
+
+/**
+ * Find the best implementation of a scaler which runs on this CPU.
+ *
+ * @param name	the name of the scaler, e.g. "hq2x"
+ * @return		the implementation, or 0 if there is no such scaler
+ */
+extern const ScalerInfo *findScaler(const char *name);
+
 // creates a 160x100 thumbnail for 320x200 games
 // and 160x120 thumbnail for 320x240 and 640x480 games
 // only 565 mode
@@ -20,6 +20,7 @@
  *
  */
 
+#include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 
 #ifdef USE_NASM
@@ -35,11 +36,11 @@ void hq2x_16(const byte *, byte *, uint32, uint32, uint32, uint32);
 
 }
 
-void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQ2xMMX(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	hq2x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
 }
 
-#else
+#endif
 
 #define PIXEL00_0	*(q) = w5;
 #define PIXEL00_10	*(q) = interpolate16_3_1<ColorMask >(w5, w1);
@@ -93,8 +94,7 @@ void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate16_2_3_3<ColorMask >(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate16_14_1_1<ColorMask >(w5, w6, w8);
 
-extern "C" uint32   *RGBtoYUV;
-#define YUV(x)	RGBtoYUV[w ## x]
+#define YUV(x)	yuv ## x
 
 /*
  * The HQ2x high quality 2x graphics filter.
@@ -104,6 +104,7 @@ extern "C" uint32   *RGBtoYUV;
 template<typename ColorMask>
 static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	register int w1, w2, w3, w4, w5, w6, w7, w8, w9;
+	int yuv1, yuv2, yuv3, yuv4, yuv5, yuv6, yuv7, yuv8, yuv9;
 
 	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
 	const uint16 *p = (const uint16 *)srcPtr;
@@ -131,6 +132,16 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
+		// The YUV values are kept in a sliding window just like the
+		// pixels, so only the new column has to be converted each step.
+		yuv1 = convertToYUV<ColorMask>(w1);
+		yuv4 = convertToYUV<ColorMask>(w4);
+		yuv7 = convertToYUV<ColorMask>(w7);
+
+		yuv2 = convertToYUV<ColorMask>(w2);
+		yuv5 = convertToYUV<ColorMask>(w5);
+		yuv8 = convertToYUV<ColorMask>(w8);
+
 		int tmpWidth = width;
 		while (tmpWidth--) {
 			p++;
@@ -139,8 +150,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+			yuv3 = convertToYUV<ColorMask>(w3);
+			yuv6 = convertToYUV<ColorMask>(w6);
+			yuv9 = convertToYUV<ColorMask>(w9);
+
 			int pattern = 0;
-			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
 			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
 			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
@@ -1950,6 +1964,14 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w5 = w6;
 			w8 = w9;
 
+			yuv1 = yuv2;
+			yuv4 = yuv5;
+			yuv7 = yuv8;
+
+			yuv2 = yuv3;
+			yuv5 = yuv6;
+			yuv8 = yuv9;
+
 			q += 2;
 		}
 		p += nextlineSrc - width;
@@ -1957,7 +1979,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	}
 }
 
-void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+void HQ2xC(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	extern int gBitFormat;
 	if (gBitFormat == 565)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
@@ -1965,4 +1987,12 @@ void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
-#endif // Assembly version
+void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+#ifdef USE_NASM
+	if (getScalerCPUFeatures() & kScalerCPUMMX) {
+		HQ2xMMX(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+#endif
+	HQ2xC(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
@@ -179,6 +179,24 @@ static inline unsigned interpolate16_1_1_1_1(unsigned p1, unsigned p2, unsigned
 	return ((p1+p2+p3+p4) - lowbits) >> 2;
 }
 
+/**
+ * Convert a 16 bit color to a YUV value (encoded 8-8-8), giving exactly the
+ * same result as the old RGBtoYUV lookup table. Computing the value takes a
+ * few ALU operations, which is cheaper than random accesses into a 256 KB
+ * table that does not fit into the cache. Used by the hq scaler family.
+ */
+template<typename ColorMask>
+static inline int convertToYUV(int color) {
+	const int r = ((color & ColorMask::kRedMask) >> ColorMask::kRedShift) << (8 - ColorMask::kRedBits);
+	const int g = ((color & ColorMask::kGreenMask) >> ColorMask::kGreenShift) << (8 - ColorMask::kGreenBits);
+	const int b = ((color & ColorMask::kBlueMask) >> ColorMask::kBlueShift) << (8 - ColorMask::kBlueBits);
+
+	const int Y = (r + g + b) >> 2;
+	const int u = 128 + ((r - b) >> 2);
+	const int v = 128 + ((-r + 2 * g - b) >> 3);
+	return (Y << 16) | (u << 8) | v;
+}
+
 /**
  * Compare two YUV values (encoded 8-8-8) and check if they differ by more than
  * a certain hard coded threshold. Used by the hq scaler family.
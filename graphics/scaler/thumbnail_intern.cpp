@@ -25,49 +25,59 @@
 #include "common/system.h"
 
 #include "graphics/colormasks.h"
+#include "graphics/conversion.h"
 #include "graphics/scaler.h"
-#include "graphics/scaler/intern.h"
 #include "graphics/palette.h"
 
-template<int bitFormat>
-uint16 quadBlockInterpolate(const uint8 *src, uint32 srcPitch) {
-	uint16 colorx1y1 = *(((const uint16 *)src));
-	uint16 colorx2y1 = *(((const uint16 *)src) + 1);
-
-	uint16 colorx1y2 = *(((const uint16 *)(src + srcPitch)));
-	uint16 colorx2y2 = *(((const uint16 *)(src + srcPitch)) + 1);
-
-	return interpolate16_1_1_1_1<Graphics::ColorMasks<bitFormat> >(colorx1y1, colorx2y1, colorx1y2, colorx2y2);
+/**
+ * Spread a RGB565 color over 32 bits, so that there are free bits above
+ * each of the components. Sums of up to 32 colors can then be computed
+ * with one addition per color, instead of one per component.
+ */
+static inline uint32 spreadColor565(uint16 color) {
+	return (color | (color << 16)) & 0x07E0F81F;
 }
 
-template<int bitFormat>
-void createThumbnail_2(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	assert(width % 2 == 0);
-	assert(height % 2 == 0);
-	for (int y = 0; y < height; y += 2) {
-		for (int x = 0; x < width; x += 2, dstPtr += 2) {
-			*((uint16*)dstPtr) = quadBlockInterpolate<bitFormat>(src + 2 * x, srcPitch);
-		}
-		dstPtr += (dstPitch - 2 * width / 2);
-		src += 2 * srcPitch;
-	}
+static inline uint16 packColor565(uint32 spread) {
+	spread &= 0x07E0F81F;
+	return (uint16)(spread | (spread >> 16));
 }
 
-template<int bitFormat>
-void createThumbnail_4(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	assert(width % 4 == 0);
-	assert(height % 4 == 0);
-	for (int y = 0; y < height; y += 4) {
-		for (int x = 0; x < width; x += 4, dstPtr += 2) {
-			uint16 upleft = quadBlockInterpolate<bitFormat>(src + 2 * x, srcPitch);
-			uint16 upright = quadBlockInterpolate<bitFormat>(src + 2 * (x + 2), srcPitch);
-			uint16 downleft = quadBlockInterpolate<bitFormat>(src + srcPitch * 2 + 2 * x, srcPitch);
-			uint16 downright = quadBlockInterpolate<bitFormat>(src + srcPitch * 2 + 2 * (x + 2), srcPitch);
-
-			*((uint16*)dstPtr) = interpolate16_1_1_1_1<Graphics::ColorMasks<bitFormat> >(upleft, upright, downleft, downright);
+/**
+ * Reduce a RGB565 image by averaging factor x factor blocks. The blocks
+ * are first summed up horizontally for each source row, and those sums
+ * are then accumulated over factor rows.
+ */
+template<int factor, int shift>
+void createThumbnail_N(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	assert(width % factor == 0);
+	assert(height % factor == 0);
+	assert(width / factor <= kThumbnailWidth);
+
+	// Half of the block size in each component, to round to nearest
+	const uint32 round = (factor * factor / 2) * 0x00200801;
+
+	uint32 sums[kThumbnailWidth];
+	const int dstWidth = width / factor;
+
+	for (int y = 0; y < height; y += factor) {
+		for (int x = 0; x < dstWidth; ++x)
+			sums[x] = round;
+
+		for (int row = 0; row < factor; ++row, src += srcPitch) {
+			const uint16 *s = (const uint16 *)src;
+			for (int x = 0; x < dstWidth; ++x) {
+				uint32 sum = 0;
+				for (int i = 0; i < factor; ++i)
+					sum += spreadColor565(*s++);
+				sums[x] += sum;
+			}
 		}
-		dstPtr += (dstPitch - 2 * width / 4);
-		src += 4 * srcPitch;
+
+		uint16 *d = (uint16 *)dstPtr;
+		for (int x = 0; x < dstWidth; ++x)
+			d[x] = packColor565(sums[x] >> shift);
+		dstPtr += dstPitch;
 	}
 }
 
@@ -79,9 +89,32 @@ static void createThumbnail(const uint8 *src, uint32 srcPitch, uint8 *dstPtr, ui
 	int downScaleMode = (width == 320) ? 2 : 4;
 
 	if (downScaleMode == 2) {
-		createThumbnail_2<565>(src, srcPitch, dstPtr, dstPitch, width, height);
+		createThumbnail_N<2, 2>(src, srcPitch, dstPtr, dstPitch, width, height);
 	} else if (downScaleMode == 4) {
-		createThumbnail_4<565>(src, srcPitch, dstPtr, dstPitch, width, height);
+		createThumbnail_N<4, 4>(src, srcPitch, dstPtr, dstPitch, width, height);
+	}
+}
+
+/**
+ * Convert palette to a table of RGB565 colors.
+ */
+static void createPalette565(uint16 *dst, const byte *palette) {
+	for (int i = 0; i < 256; ++i, palette += 3)
+		dst[i] = Graphics::RGBToColor<Graphics::ColorMasks<565> >(palette[0], palette[1], palette[2]);
+}
+
+/**
+ * Convert a CLUT8 image to RGB565.
+ */
+static void convertCLUT8To565(uint16 *dst, int dstW, const uint8 *src, int srcPitch, int w, int h, const byte *palette) {
+	uint16 palette565[256];
+	createPalette565(palette565, palette);
+
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x)
+			dst[x] = palette565[src[x]];
+		dst += dstW;
+		src += srcPitch;
 	}
 }
 
@@ -104,32 +137,16 @@ static bool grabScreen565(Graphics::Surface *surf) {
 
 	surf->create(screen->w, screen->h, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
 
-	byte *palette = 0;
 	if (screenFormat.bytesPerPixel == 1) {
-		palette = new byte[256 * 3];
-		assert(palette);
+		byte palette[256 * 3];
 		g_system->getPaletteManager()->grabPalette(palette, 0, 256);
-	}
 
-	for (uint y = 0; y < screen->h; ++y) {
-		for (uint x = 0; x < screen->w; ++x) {
-			byte r = 0, g = 0, b = 0;
-
-			if (screenFormat.bytesPerPixel == 1) {
-				r = palette[((uint8*)screen->pixels)[y * screen->pitch + x] * 3];
-				g = palette[((uint8*)screen->pixels)[y * screen->pitch + x] * 3 + 1];
-				b = palette[((uint8*)screen->pixels)[y * screen->pitch + x] * 3 + 2];
-			} else if (screenFormat.bytesPerPixel == 2) {
-				uint16 col = READ_UINT16(screen->getBasePtr(x, y));
-				screenFormat.colorToRGB(col, r, g, b);
-			}
-
-			((uint16 *)surf->pixels)[y * surf->w + x] = Graphics::RGBToColor<Graphics::ColorMasks<565> >(r, g, b);
-		}
+		convertCLUT8To565((uint16 *)surf->pixels, surf->w, (const uint8 *)screen->pixels, screen->pitch, screen->w, screen->h, palette);
+	} else if (screenFormat.bytesPerPixel == 2) {
+		Graphics::crossBlit((byte *)surf->pixels, (const byte *)screen->pixels, surf->pitch, screen->pitch,
+		                    screen->w, screen->h, surf->format, screenFormat);
 	}
 
-	delete[] palette;
-
 	g_system->unlockScreen();
 	return true;
 }
@@ -223,16 +240,7 @@ bool createThumbnail(Graphics::Surface *surf, const uint8 *pixels, int w, int h,
 	Graphics::Surface screen;
 	screen.create(w, h, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
 
-	for (uint y = 0; y < screen.h; ++y) {
-		for (uint x = 0; x < screen.w; ++x) {
-			byte r, g, b;
-			r = palette[pixels[y * w + x] * 3];
-			g = palette[pixels[y * w + x] * 3 + 1];
-			b = palette[pixels[y * w + x] * 3 + 2];
-
-			((uint16 *)screen.pixels)[y * screen.w + x] = Graphics::RGBToColor<Graphics::ColorMasks<565> >(r, g, b);
-		}
-	}
+	convertCLUT8To565((uint16 *)screen.pixels, screen.w, pixels, w, w, h, palette);
 
 	return createThumbnail(*surf, screen);
 }
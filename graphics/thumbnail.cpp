@@ -109,14 +109,28 @@ Graphics::Surface *loadThumbnail(Common::SeekableReadStream &in) {
 	Graphics::Surface *const to = new Graphics::Surface();
 	to->create(header.width, header.height, format);
 
-	OverlayColor *pixels = (OverlayColor *)to->pixels;
-	for (int y = 0; y < to->h; ++y) {
-		for (int x = 0; x < to->w; ++x) {
-			uint8 r, g, b;
-			colorToRGB<ColorMasks<565> >(in.readUint16BE(), r, g, b);
+	// Read all pixels at once, and convert them to the overlay format in place
+	uint16 *pixels = (uint16 *)to->pixels;
+	const uint32 numPixels = to->w * to->h;
+	if (in.read(pixels, numPixels * 2) != numPixels * 2) {
+		warning("Thumbnail data is truncated");
+		to->free();
+		delete to;
+		return 0;
+	}
 
-			// converting to current OSystem Color
-			*pixels++ = format.RGBToColor(r, g, b);
+	// The thumbnail is stored as big endian RGB565. Other formats go through
+	// RGBToColor(), so the pixels come out opaque in formats with alpha.
+	if (format == createPixelFormat<565>()) {
+#ifndef SCUMM_BIG_ENDIAN
+		for (uint32 i = 0; i < numPixels; ++i)
+			pixels[i] = FROM_BE_16(pixels[i]);
+#endif
+	} else {
+		for (uint32 i = 0; i < numPixels; ++i) {
+			uint8 r, g, b;
+			colorToRGB<ColorMasks<565> >(FROM_BE_16(pixels[i]), r, g, b);
+			pixels[i] = format.RGBToColor(r, g, b);
 		}
 	}
 
@@ -159,9 +173,14 @@ bool saveThumbnail(Common::WriteStream &out, const Graphics::Surface &thumb) {
 	out.writeByte(header.bpp);
 
 	// TODO: for later this shouldn't be casted to uint16...
-	uint16 *pixels = (uint16 *)thumb.pixels;
-	for (uint16 p = 0; p < thumb.w*thumb.h; ++p, ++pixels)
-		out.writeUint16BE(*pixels);
+	const uint16 *pixels = (const uint16 *)thumb.pixels;
+	uint16 *row = new uint16[thumb.w];
+	for (uint16 y = 0; y < thumb.h; ++y, pixels += thumb.w) {
+		for (uint16 x = 0; x < thumb.w; ++x)
+			WRITE_BE_UINT16(row + x, pixels[x]);
+		out.write(row, thumb.w * 2);
+	}
+	delete[] row;
 
 	return true;
 }
@@ -58,6 +58,11 @@ Graphics::Surface *loadThumbnail(Common::SeekableReadStream &in);
 /**
  * Saves a thumbnail to the given write stream.
  * Automatically creates a thumbnail from screen contents.
+ *
+ * This runs synchronously: the engines expect the thumbnail to be in the
+ * stream when this returns, since the savegame data follows it.
+ * TODO: Grab the screen here and downscale/write it on a worker thread,
+ * which needs a way for the engines to finish save streams later.
  */
 bool saveThumbnail(Common::WriteStream &out);
 
@@ -84,10 +84,16 @@
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 
 #include "graphics/surface.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace Graphics {
 
 class YUVToRGBLookup {
@@ -162,26 +168,42 @@ private:
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
-	Graphics::PixelFormat _lastFormat;
-	YUVToRGBLookup *_lookup;
+	struct CachedLookup {
+		Graphics::PixelFormat format;
+		YUVToRGBLookup *lookup;
+	};
+
+	// The lookups for all formats used so far. There are rarely more than
+	// one or two of them, and they are small, so they are kept around
+	// instead of being rebuilt whenever the format changes.
+	Common::Array<CachedLookup> _lookups;
+
+	// Videos may be decoded outside the main thread, e.g. from a timer
+	// callback, so the cache may be used by several threads at once.
+	Common::Mutex _lookupsMutex;
 };
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i].lookup;
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format) {
-	if (_lastFormat == format)
-		return _lookup;
+	Common::StackLock lock(_lookupsMutex);
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format);
-	_lastFormat = format;
-	return _lookup;
+	for (uint i = 0; i < _lookups.size(); i++) {
+		if (_lookups[i].format == format)
+			return _lookups[i].lookup;
+	}
+
+	CachedLookup cached;
+	cached.format = format;
+	cached.lookup = new YUVToRGBLookup(format);
+	_lookups.push_back(cached);
+	return cached.lookup;
 }
 
 } // End of namespace Graphics
@@ -194,12 +216,149 @@ DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 
 namespace Graphics {
 
-#define PUT_PIXEL(s, d) \
-	L = &rgbToPix[(s)]; \
-	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
+#ifdef __SSE2__
+
+/**
+ * Combine 16 clamped 8-bit values per component into pixels of the given
+ * format, the way PixelFormat::RGBToColor() does, and store them.
+ */
+template<typename PixelInt>
+static inline void storePixelsSSE2(PixelInt *dst, __m128i red, __m128i green, __m128i blue, __m128i alpha,
+		__m128i rLoss, __m128i gLoss, __m128i bLoss, __m128i rShift, __m128i gShift, __m128i bShift) {
+	const __m128i zero = _mm_setzero_si128();
+
+	for (int half = 0; half < 2; half++) {
+		const __m128i r16 = half ? _mm_unpackhi_epi8(red, zero) : _mm_unpacklo_epi8(red, zero);
+		const __m128i g16 = half ? _mm_unpackhi_epi8(green, zero) : _mm_unpacklo_epi8(green, zero);
+		const __m128i b16 = half ? _mm_unpackhi_epi8(blue, zero) : _mm_unpacklo_epi8(blue, zero);
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i pix = _mm_or_si128(alpha, _mm_sll_epi16(_mm_srl_epi16(r16, rLoss), rShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi16(_mm_srl_epi16(g16, gLoss), gShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi16(_mm_srl_epi16(b16, bLoss), bShift));
+			_mm_storeu_si128((__m128i *)(dst + 8 * half), pix);
+		} else {
+			__m128i pix = _mm_or_si128(alpha, _mm_sll_epi32(_mm_srl_epi32(_mm_unpacklo_epi16(r16, zero), rLoss), rShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi32(_mm_srl_epi32(_mm_unpacklo_epi16(g16, zero), gLoss), gShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi32(_mm_srl_epi32(_mm_unpacklo_epi16(b16, zero), bLoss), bShift));
+			_mm_storeu_si128((__m128i *)(dst + 8 * half), pix);
+
+			pix = _mm_or_si128(alpha, _mm_sll_epi32(_mm_srl_epi32(_mm_unpackhi_epi16(r16, zero), rLoss), rShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi32(_mm_srl_epi32(_mm_unpackhi_epi16(g16, zero), gLoss), gShift));
+			pix = _mm_or_si128(pix, _mm_sll_epi32(_mm_srl_epi32(_mm_unpackhi_epi16(b16, zero), bLoss), bShift));
+			_mm_storeu_si128((__m128i *)(dst + 8 * half + 4), pix);
+		}
+	}
+}
+
+/**
+ * Convert two rows of pixels, eight chroma samples (16 pixels per row) at
+ * a time, with SSE2.
+ *
+ * The lookup tables just add the chroma offsets to the luma value, clamp the
+ * result and combine the components with PixelFormat::RGBToColor(), so doing
+ * that with saturating arithmetic gives exactly the same pixels.
+ *
+ * @return the number of chroma samples converted
+ */
+template<typename PixelInt>
+static int convertYUV420ToRGBRowsSSE2(PixelInt *dst0, PixelInt *dst1, const Graphics::PixelFormat &format, const int16 *colorTab,
+		const byte *y0, const byte *y1, const byte *uSrc, const byte *vSrc, int halfWidth) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	// The table entries point into the component parts of the rgbToPix
+	// table, subtract that again to get the plain offsets
+	const __m128i rBase = _mm_set1_epi16(0 * 768 + 256);
+	const __m128i gBase = _mm_set1_epi16(1 * 768 + 256);
+	const __m128i bBase = _mm_set1_epi16(2 * 768 + 256);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i alpha = (sizeof(PixelInt) == 2) ? _mm_set1_epi16((int16)format.RGBToColor(0, 0, 0)) : _mm_set1_epi32(format.RGBToColor(0, 0, 0));
+
+	// The usual 32bpp formats have byte sized components (and an 8-bit alpha
+	// or none at all), which allows for much cheaper packing
+	const __m128i alphaPlane = _mm_set1_epi8((char)0xFF);
+	const bool bytePlanes = format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+		(format.rShift % 8) == 0 && (format.gShift % 8) == 0 && (format.bShift % 8) == 0 &&
+		(format.aLoss == 8 || (format.aLoss == 0 && (format.aShift % 8) == 0));
+
+	int w = 0;
+	for (; w + 8 <= halfWidth; w += 8) {
+		__m128i cr_r = zero, cr_g = zero, cb_g = zero, cb_b = zero;
+
+#define LOAD_CHROMA(i) \
+		cr_r = _mm_insert_epi16(cr_r, Cr_r_tab[vSrc[w + i]], i); \
+		cr_g = _mm_insert_epi16(cr_g, Cr_g_tab[vSrc[w + i]], i); \
+		cb_g = _mm_insert_epi16(cb_g, Cb_g_tab[uSrc[w + i]], i); \
+		cb_b = _mm_insert_epi16(cb_b, Cb_b_tab[uSrc[w + i]], i)
+
+		LOAD_CHROMA(0); LOAD_CHROMA(1); LOAD_CHROMA(2); LOAD_CHROMA(3);
+		LOAD_CHROMA(4); LOAD_CHROMA(5); LOAD_CHROMA(6); LOAD_CHROMA(7);
+
+#undef LOAD_CHROMA
+
+		const __m128i rOff = _mm_sub_epi16(cr_r, rBase);
+		const __m128i gOff = _mm_sub_epi16(_mm_add_epi16(cr_g, cb_g), gBase);
+		const __m128i bOff = _mm_sub_epi16(cb_b, bBase);
+
+		// Each chroma sample covers two neighboring pixels
+		const __m128i rOffLo = _mm_unpacklo_epi16(rOff, rOff), rOffHi = _mm_unpackhi_epi16(rOff, rOff);
+		const __m128i gOffLo = _mm_unpacklo_epi16(gOff, gOff), gOffHi = _mm_unpackhi_epi16(gOff, gOff);
+		const __m128i bOffLo = _mm_unpacklo_epi16(bOff, bOff), bOffHi = _mm_unpackhi_epi16(bOff, bOff);
+
+		for (int row = 0; row < 2; row++) {
+			const __m128i luma = _mm_loadu_si128((const __m128i *)((row ? y1 : y0) + 2 * w));
+			const __m128i lumaLo = _mm_unpacklo_epi8(luma, zero);
+			const __m128i lumaHi = _mm_unpackhi_epi8(luma, zero);
+
+			// Packing with unsigned saturation clamps to 0-255, just like the
+			// spread out ends of the rgbToPix table
+			const __m128i red = _mm_packus_epi16(_mm_add_epi16(lumaLo, rOffLo), _mm_add_epi16(lumaHi, rOffHi));
+			const __m128i green = _mm_packus_epi16(_mm_add_epi16(lumaLo, gOffLo), _mm_add_epi16(lumaHi, gOffHi));
+			const __m128i blue = _mm_packus_epi16(_mm_add_epi16(lumaLo, bOffLo), _mm_add_epi16(lumaHi, bOffHi));
+
+			if (sizeof(PixelInt) == 4 && bytePlanes) {
+				// Every component fills one whole byte of the pixel, so just
+				// interleave the bytes
+				__m128i planes[4] = { zero, zero, zero, zero };
+				planes[format.rShift / 8] = red;
+				planes[format.gShift / 8] = green;
+				planes[format.bShift / 8] = blue;
+				if (format.aLoss == 0)
+					planes[format.aShift / 8] = alphaPlane;
+
+				const __m128i lo01 = _mm_unpacklo_epi8(planes[0], planes[1]);
+				const __m128i hi01 = _mm_unpackhi_epi8(planes[0], planes[1]);
+				const __m128i lo23 = _mm_unpacklo_epi8(planes[2], planes[3]);
+				const __m128i hi23 = _mm_unpackhi_epi8(planes[2], planes[3]);
+
+				PixelInt *dst = (row ? dst1 : dst0) + 2 * w;
+				_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(lo01, lo23));
+				_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(lo01, lo23));
+				_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpacklo_epi16(hi01, hi23));
+				_mm_storeu_si128((__m128i *)(dst + 12), _mm_unpackhi_epi16(hi01, hi23));
+			} else {
+				storePixelsSSE2<PixelInt>((row ? dst1 : dst0) + 2 * w, red, green, blue, alpha, rLoss, gLoss, bLoss, rShift, gShift, bShift);
+			}
+		}
+	}
+
+	return w;
+}
+
+#endif
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const Graphics::PixelFormat &format, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
@@ -211,29 +370,43 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const uint32 *rgbToPix = lookup->_rgbToPix;
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			register const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
+		// Each chroma sample covers two pixels in two rows
+		PixelInt *dst0 = (PixelInt *)dstPtr;
+		PixelInt *dst1 = (PixelInt *)(dstPtr + dstPitch);
+		const byte *y0 = ySrc;
+		const byte *y1 = ySrc + yPitch;
+		int w = 0;
+
+#ifdef __SSE2__
+		w = convertYUV420ToRGBRowsSSE2<PixelInt>(dst0, dst1, format, Cr_r_tab, y0, y1, uSrc, vSrc, halfWidth);
+		dst0 += 2 * w;
+		dst1 += 2 * w;
+		y0 += 2 * w;
+		y1 += 2 * w;
+#endif
+
+		for (; w < halfWidth; w++) {
+			// Offset the table for each component once per chroma sample,
+			// so every pixel only takes three lookups by its luma value
+			const uint32 *rTab = rgbToPix + Cr_r_tab[vSrc[w]];
+			const uint32 *gTab = rgbToPix + Cr_g_tab[vSrc[w]] + Cb_g_tab[uSrc[w]];
+			const uint32 *bTab = rgbToPix + Cb_b_tab[uSrc[w]];
+
+			dst0[0] = rTab[y0[0]] | gTab[y0[0]] | bTab[y0[0]];
+			dst0[1] = rTab[y0[1]] | gTab[y0[1]] | bTab[y0[1]];
+			dst1[0] = rTab[y1[0]] | gTab[y1[0]] | bTab[y1[0]];
+			dst1[1] = rTab[y1[1]] | gTab[y1[1]] | bTab[y1[1]];
+
+			dst0 += 2;
+			dst1 += 2;
+			y0 += 2;
+			y1 += 2;
 		}
 
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
 	}
 }
 
@@ -249,9 +422,9 @@ void convertYUV420ToRGB(Graphics::Surface *dst, const byte *ySrc, const byte *uS
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->pixels, dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->pixels, dst->pitch, dst->format, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->pixels, dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->pixels, dst->pitch, dst->format, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 } // End of namespace Graphics
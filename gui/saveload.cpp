@@ -241,7 +241,7 @@ void SaveLoadChooser::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && !_list->getSelectedString().empty() && _metaInfoSupport) {
-		SaveStateDescriptor desc = (*_plugin)->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot());
+		const SaveStateDescriptor &desc = getMetaInfos(_saveList[selItem].getSaveSlot());
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag();
@@ -315,13 +315,23 @@ void SaveLoadChooser::close() {
 	_plugin = 0;
 	_target.clear();
 	_saveList.clear();
+	_metaInfoCache.clear();
 	_list->setList(StringArray());
 
 	Dialog::close();
 }
 
+const SaveStateDescriptor &SaveLoadChooser::getMetaInfos(int slot) {
+	MetaInfoCache::iterator i = _metaInfoCache.find(slot);
+	if (i != _metaInfoCache.end())
+		return i->_value;
+
+	return _metaInfoCache[slot] = (*_plugin)->querySaveMetaInfos(_target.c_str(), slot);
+}
+
 void SaveLoadChooser::updateSaveList() {
 	_saveList = (*_plugin)->listSaves(_target.c_str());
+	_metaInfoCache.clear();
 
 	int curSlot = 0;
 	int saveSlot = 0;
@@ -24,6 +24,7 @@
 
 #include "gui/dialog.h"
 #include "engines/metaengine.h"
+#include "common/hashmap.h"
 
 namespace GUI {
 
@@ -57,10 +58,19 @@ protected:
 	SaveStateList			_saveList;
 	String					_resultString;
 
+	/**
+	 * Meta infos of the savegames which were already selected, by slot.
+	 * This avoids reading and decoding the thumbnail again each time
+	 * the selection moves back to a savegame.
+	 */
+	typedef Common::HashMap<int, SaveStateDescriptor> MetaInfoCache;
+	MetaInfoCache			_metaInfoCache;
+
 	uint8 _fillR, _fillG, _fillB;
 
 	void updateSaveList();
 	void updateSelection(bool redraw);
+	const SaveStateDescriptor &getMetaInfos(int slot);
 public:
 	SaveLoadChooser(const String &title, const String &buttonLabel);
 	~SaveLoadChooser();
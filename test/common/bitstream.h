@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+
+class BitStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void test_be() {
+		const byte data[] = { 0xA5, 0x3C };
+		Common::BitStreamBE bs(data, 16);
+
+		TS_ASSERT(Common::BitStreamBE::isMSB2LSB());
+		TS_ASSERT_EQUALS(bs.size(), 16u);
+		TS_ASSERT_EQUALS(bs.getBit(), 1u);
+		TS_ASSERT_EQUALS(bs.getBits(2), 1u);
+		TS_ASSERT_EQUALS(bs.peekBits(6), 10u);
+		TS_ASSERT_EQUALS(bs.pos(), 3u);
+		TS_ASSERT_EQUALS(bs.getBits(6), 10u);
+		TS_ASSERT_EQUALS(bs.getBits(7), 60u);
+		TS_ASSERT_EQUALS(bs.pos(), 16u);
+
+		// Reading past the end gives zeros when peeking
+		TS_ASSERT_EQUALS(bs.peekBits(8), 0u);
+	}
+
+	void test_le() {
+		const byte data[] = { 0xA5, 0x3C };
+		Common::BitStreamLE bs(data, 16);
+
+		TS_ASSERT(!Common::BitStreamLE::isMSB2LSB());
+		TS_ASSERT_EQUALS(bs.getBits(3), 5u);
+		TS_ASSERT_EQUALS(bs.peekBits(6), 20u);
+		TS_ASSERT_EQUALS(bs.getBits(6), 20u);
+		bs.skip(1);
+		TS_ASSERT_EQUALS(bs.getBits(6), 15u);
+		TS_ASSERT_EQUALS(bs.pos(), 16u);
+	}
+
+	void test_32le() {
+		const byte data[] = { 0x01, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x00 };
+		Common::BitStream32LE bs(data, 64);
+
+		TS_ASSERT_EQUALS(bs.peekBits(32), 0x80000001u);
+		TS_ASSERT_EQUALS(bs.getBit(), 1u);
+		TS_ASSERT_EQUALS(bs.getBits(30), 0u);
+
+		// Values spanning two words
+		TS_ASSERT_EQUALS(bs.getBits(5), 0x1Fu);
+		TS_ASSERT_EQUALS(bs.pos(), 36u);
+
+		uint32 x = 0;
+		for (uint32 i = 0; i < 6; i++)
+			bs.addBit(x, i);
+		TS_ASSERT_EQUALS(x, 0x0Fu);
+	}
+
+	void test_past_end() {
+		// One value past the end reads as zero, like the stream based readers
+		const byte data[] = { 0xFF };
+		Common::BitStreamBE bs(data, 8);
+
+		TS_ASSERT_EQUALS(bs.getBits(8), 0xFFu);
+		TS_ASSERT_EQUALS(bs.getBit(), 0u);
+		TS_ASSERT_EQUALS(bs.getBits(7), 0u);
+		TS_ASSERT_EQUALS(bs.pos(), 16u);
+
+		const byte data32[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+		Common::BitStream32LE bs32(data32, 32);
+
+		bs32.skip(30);
+		TS_ASSERT_EQUALS(bs32.getBits(4), 3u);
+		TS_ASSERT_EQUALS(bs32.peekBits(32), 0u);
+		bs32.skip(30);
+		TS_ASSERT_EQUALS(bs32.pos(), 64u);
+	}
+
+	void test_addBit_be() {
+		const byte data[] = { 0xC0 };
+		Common::BitStreamBE bs(data, 8);
+
+		uint32 x = 0;
+		for (uint32 i = 0; i < 3; i++)
+			bs.addBit(x, i);
+		TS_ASSERT_EQUALS(x, 6u);
+	}
+};
@@ -0,0 +1,73 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+
+class HuffmanTestSuite : public CxxTest::TestSuite {
+public:
+	void test_be() {
+		const uint32 codes[] = { 0, 2, 6, 7 };
+		const uint8 lengths[] = { 1, 2, 3, 3 };
+		Common::Huffman h(0, 4, codes, lengths);
+
+		// 10 0 111 110
+		const byte data[] = { 0x9F, 0x00 };
+		Common::BitStreamBE bs(data, 16);
+
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 1u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 0u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 3u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 2u);
+		TS_ASSERT_EQUALS(bs.pos(), 9u);
+	}
+
+	void test_le() {
+		// The first bit read is the LSB of the code: 0, 10, 110 and 111
+		const uint32 codes[] = { 0, 1, 3, 7 };
+		const uint8 lengths[] = { 1, 2, 3, 3 };
+		const uint32 symbols[] = { 'a', 'b', 'c', 'd' };
+		Common::Huffman h(0, 4, codes, lengths, symbols);
+
+		// 10 0 111 110
+		const byte data[] = { 0xF9, 0x00 };
+		Common::BitStreamLE bs(data, 16);
+
+		TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)'b');
+		TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)'a');
+		TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)'d');
+		TS_ASSERT_EQUALS(h.getSymbol(bs), (uint32)'c');
+		TS_ASSERT_EQUALS(bs.pos(), 9u);
+	}
+
+	void test_long_codes() {
+		// Codes longer than the prefix table
+		const uint32 codes[] = { 0, 0x800, 0x801 };
+		const uint8 lengths[] = { 1, 12, 12 };
+		const uint32 symbols[] = { 10, 20, 30 };
+		Common::Huffman h(0, 3, codes, lengths, symbols);
+
+		// 100000000001 0 100000000000
+		const byte data[] = { 0x80, 0x14, 0x00, 0x00 };
+		Common::BitStreamBE bs(data, 32);
+
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 30u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 10u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 20u);
+		TS_ASSERT_EQUALS(bs.pos(), 25u);
+	}
+
+	void test_setSymbols() {
+		const uint32 codes[] = { 0, 1 };
+		const uint8 lengths[] = { 1, 1 };
+		Common::Huffman h(0, 2, codes, lengths);
+
+		const uint32 symbols[] = { 5, 7 };
+		h.setSymbols(symbols);
+
+		const byte data[] = { 0x40 };
+		Common::BitStreamBE bs(data, 8);
+
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 5u);
+		TS_ASSERT_EQUALS(h.getSymbol(bs), 7u);
+	}
+};
@@ -0,0 +1,41 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/perfcounters.h"
+
+class PerfCountersTestSuite : public CxxTest::TestSuite {
+public:
+	void test_publish() {
+		Common::PerfCounters &counters = g_perfCounters;
+		Common::PerfCounters::CounterId time = counters.registerCounter("test time", Common::PerfCounters::kAveragePerFrame);
+		Common::PerfCounters::CounterId events = counters.registerCounter("test events", Common::PerfCounters::kTotalPerSecond);
+
+		TS_ASSERT_EQUALS(counters.registerCounter("test time", Common::PerfCounters::kAveragePerFrame), time);
+		TS_ASSERT_EQUALS(counters.getName(events), "test events");
+
+		// Nothing is counted while disabled
+		counters.add(time, 100);
+		TS_ASSERT(!counters.frameDone(0));
+		TS_ASSERT(!counters.frameDone(2000));
+
+		counters.setEnabled(true);
+		TS_ASSERT(!counters.frameDone(1000));
+
+		for (int i = 1; i <= 3; ++i) {
+			counters.add(time, i);
+			counters.add(events, 1);
+			TS_ASSERT_EQUALS(counters.frameDone(1000 + i * 500), i == 2);
+		}
+
+		// Two frames in one second
+		TS_ASSERT_EQUALS(counters.getValue(time), 1.5f);
+		TS_ASSERT_EQUALS(counters.getValue(events), 2.0f);
+		TS_ASSERT_EQUALS(counters.getFrameRate(), 2.0f);
+
+		counters.add(time, 4);
+		TS_ASSERT(counters.frameDone(3000));
+		TS_ASSERT_EQUALS(counters.getValue(time), 3.5f);
+
+		counters.setEnabled(false);
+		TS_ASSERT_EQUALS(counters.getValue(time), 0.0f);
+	}
+};
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/bufferedstream.h"
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -56,6 +57,25 @@ static uint16 getStreamType(uint32 tag) {
 	return tag & 0xffff;
 }
 
+static bool isVideoChunk(uint32 tag) {
+	uint16 streamType = getStreamType(tag);
+	return streamType == 'dc' || streamType == 'id' || streamType == 'AM' || streamType == '32' || streamType == 'iv';
+}
+
+static bool isChunkAt(Common::SeekableReadStream *stream, uint32 offset, uint32 tag) {
+	if (offset + 8 > (uint32)stream->size())
+		return false;
+
+	stream->seek(offset);
+	return stream->readUint32BE() == tag;
+}
+
+enum {
+	// The packets are small and read in order, so read the file in large
+	// blocks instead of doing a small read for every chunk
+	kReadBufferSize = 128 * 1024
+};
+
 AviDecoder::AviDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) : _mixer(mixer) {
 	_soundType = soundType;
 
@@ -63,9 +83,13 @@ AviDecoder::AviDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) :
 	_decodedHeader = false;
 	_audStream = NULL;
 	_fileStream = NULL;
+	_movieListStart = 0;
+	_movieListEnd = 0;
+	_audioStartOffset = 0;
 	_audHandle = new Audio::SoundHandle();
 	_dirtyPalette = false;
 	memset(_palette, 0, sizeof(_palette));
+	memset(_initialPalette, 0, sizeof(_initialPalette));
 	memset(&_wvInfo, 0, sizeof(PCMWAVEFORMAT));
 	memset(&_bmInfo, 0, sizeof(BITMAPINFOHEADER));
 	memset(&_vidsHeader, 0, sizeof(AVIStreamHeader));
@@ -121,6 +145,7 @@ void AviDecoder::runHandle(uint32 tag) {
 			} break;
 		case ID_IDX1:
 			_ixInfo.size = _fileStream->readUint32LE();
+			delete[] _ixInfo.indices;
 			_ixInfo.indices = new AVIOLDINDEX::Index[_ixInfo.size / 16];
 			debug (0, "%d Indices", (_ixInfo.size / 16));
 			for (uint32 i = 0; i < (_ixInfo.size / 16); i++) {
@@ -205,6 +230,7 @@ void AviDecoder::handleStreamHeader() {
 				_fileStream->readByte();
 			}
 
+			memcpy(_initialPalette, _palette, sizeof(_palette));
 			_dirtyPalette = true;
 		}
 
@@ -233,7 +259,7 @@ void AviDecoder::handleStreamHeader() {
 bool AviDecoder::loadStream(Common::SeekableReadStream *stream) {
 	close();
 
-	_fileStream = stream;
+	_fileStream = Common::wrapBufferedSeekableReadStream(stream, kReadBufferSize, DisposeAfterUse::YES);
 	_decodedHeader = false;
 
 	// Read chunks until we have decoded the header
@@ -250,12 +276,20 @@ bool AviDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	// Ignore the 'movi' LIST
 	if (nextTag == ID_LIST) {
-		_fileStream->readUint32BE(); // Skip size
+		uint32 listSize = _fileStream->readUint32LE();
+		_movieListStart = _fileStream->pos();
+		_movieListEnd = _movieListStart + listSize + (listSize & 1);
 		if (_fileStream->readUint32BE() != ID_MOVI)
 			error ("Expected 'movi' LIST");
 	} else
 		error ("Expected 'movi' LIST");
 
+	// The index follows the 'movi' LIST, so read it now and come back
+	if (_header.flags & AVIF_HASINDEX) {
+		readIndex();
+		_fileStream->seek(_movieListStart + 4);
+	}
+
 	// Now, create the codec
 	_videoCodec = createCodec();
 
@@ -291,11 +325,17 @@ void AviDecoder::close() {
 
 	delete _videoCodec;
 	_videoCodec = 0;
+	_framePacket.clear();
 
 	delete[] _ixInfo.indices;
 	_ixInfo.indices = 0;
+	_frameChunks.clear();
+	_movieListStart = 0;
+	_movieListEnd = 0;
+	_audioStartOffset = 0;
 
 	memset(_palette, 0, sizeof(_palette));
+	memset(_initialPalette, 0, sizeof(_initialPalette));
 	memset(&_wvInfo, 0, sizeof(PCMWAVEFORMAT));
 	memset(&_bmInfo, 0, sizeof(BITMAPINFOHEADER));
 	memset(&_vidsHeader, 0, sizeof(AVIStreamHeader));
@@ -307,11 +347,151 @@ void AviDecoder::close() {
 
 uint32 AviDecoder::getElapsedTime() const {
 	if (_audStream)
-		return _mixer->getSoundElapsedTime(*_audHandle);
+		return _mixer->getSoundElapsedTime(*_audHandle) + _audioStartOffset;
 
 	return FixedRateVideoDecoder::getElapsedTime();
 }
 
+void AviDecoder::readIndex() {
+	_fileStream->seek(_movieListEnd);
+
+	if (_fileStream->readUint32BE() != ID_IDX1) {
+		warning("AVI index not found, seeking is not possible");
+		return;
+	}
+
+	runHandle(ID_IDX1);
+
+	uint32 indexCount = _ixInfo.size / 16;
+
+	for (uint32 i = 0; i < indexCount; i++)
+		if (isVideoChunk(_ixInfo.indices[i].id))
+			_frameChunks.push_back(i);
+
+	if (_frameChunks.empty())
+		return;
+
+	// The offsets are usually relative to the 'movi' LIST type, but some
+	// files use absolute offsets. The first chunk can't be in front of the
+	// 'movi' LIST, so that tells them apart. Then store absolute offsets.
+	uint32 indexBase = (_ixInfo.indices[0].offset < _movieListStart) ? _movieListStart : 0;
+	const AVIOLDINDEX::Index &firstFrame = _ixInfo.indices[_frameChunks[0]];
+
+	if (!isChunkAt(_fileStream, firstFrame.offset + indexBase, firstFrame.id)) {
+		warning("Invalid AVI index, seeking is not possible");
+		_frameChunks.clear();
+		return;
+	}
+
+	for (uint32 i = 0; i < indexCount; i++)
+		_ixInfo.indices[i].offset += indexBase;
+}
+
+void AviDecoder::seekToTime(Audio::Timestamp time) {
+	if (getFrameCount() == 0)
+		return;
+
+	// Round down to the frame showing at that time. Time is counted in
+	// units of 1/rate seconds, and each frame lasts scale units. The whole
+	// seconds are divided separately, so secs * rate can't overflow.
+	const uint32 rate = _vidsHeader.rate;
+	const uint32 scale = _vidsHeader.scale;
+	Audio::Timestamp mediaTime = time.convertToFramerate(rate);
+	uint32 frame = mediaTime.secs() * (rate / scale) + (mediaTime.secs() * (rate % scale) + mediaTime.numberOfFrames()) / scale;
+
+	if (frame >= getFrameCount())
+		frame = getFrameCount() - 1;
+
+	seekToFrame(frame);
+}
+
+uint32 AviDecoder::getDuration() const {
+	return Audio::Timestamp(0, _header.totalFrames * _vidsHeader.scale, _vidsHeader.rate).msecs();
+}
+
+void AviDecoder::seekToFrame(uint32 frame) {
+	if (frame != 0 && _frameChunks.size() <= frame) {
+		warning("Cannot seek to frame %d of an AVI video without an index", frame);
+		return;
+	}
+
+	if (frame == 0) {
+		_fileStream->seek(_movieListStart + 4);
+		_curFrame = -1;
+		replayPalChanges(0);
+	} else {
+		// Track down the key frame. If there's none between the last decoded
+		// frame and the requested one, just keep decoding from where we are.
+		int32 keyFrame = frame;
+		while (keyFrame > 0 && !(_ixInfo.indices[_frameChunks[keyFrame]].flags & AVIIF_INDEX))
+			keyFrame--;
+
+		if (_curFrame + 1 < keyFrame || _curFrame >= (int32)frame)
+			_curFrame = keyFrame - 1;
+
+		// Decode up to the requested frame, only looking at the video and
+		// palette chunks. The audio restarts at the new position.
+		uint32 startChunk = _frameChunks[_curFrame + 1];
+		uint32 endChunk = _frameChunks[frame - 1];
+
+		replayPalChanges(startChunk);
+
+		for (uint32 i = startChunk; i <= endChunk; i++) {
+			const AVIOLDINDEX::Index &index = _ixInfo.indices[i];
+
+			if (isVideoChunk(index.id)) {
+				_fileStream->seek(index.offset + 4);
+				_curFrame++;
+				decodeFrameChunk(_fileStream->readUint32LE());
+			} else if (getStreamType(index.id) == 'pc') {
+				_fileStream->seek(index.offset + 4);
+				handlePalChange();
+			}
+		}
+
+		// Continue with the chunks following the previous frame
+		const AVIOLDINDEX::Index &lastIndex = _ixInfo.indices[endChunk];
+		_fileStream->seek(lastIndex.offset + 8 + lastIndex.size + (lastIndex.size & 1));
+	}
+
+	// Adjust the video starting point
+	uint32 curVideoTime = Audio::Timestamp(0, frame * _vidsHeader.scale, _vidsHeader.rate).msecs();
+	_startTime = g_system->getMillis() - curVideoTime;
+	resetPauseStartTime();
+
+	restartAudio(curVideoTime);
+}
+
+void AviDecoder::replayPalChanges(uint32 endChunk) {
+	if (_bmInfo.bitCount != 8)
+		return;
+
+	// Start over with the palette from the header, so seeking backwards
+	// doesn't keep the palette of a later position
+	memcpy(_palette, _initialPalette, sizeof(_palette));
+	_dirtyPalette = true;
+
+	for (uint32 i = 0; i < endChunk; i++) {
+		const AVIOLDINDEX::Index &index = _ixInfo.indices[i];
+
+		if (getStreamType(index.id) == 'pc') {
+			_fileStream->seek(index.offset + 4);
+			handlePalChange();
+		}
+	}
+}
+
+void AviDecoder::restartAudio(uint32 startTime) {
+	if (!_audStream)
+		return;
+
+	// Throw away the queued audio and start over from here
+	_mixer->stopHandle(*_audHandle);
+	_audStream = createAudioStream();
+	_mixer->playStream(_soundType, _audHandle, _audStream);
+	_audioStartOffset = startTime;
+}
+
 const Graphics::Surface *AviDecoder::decodeNextFrame() {
 	uint32 nextTag = _fileStream->readUint32BE();
 
@@ -343,52 +523,60 @@ const Graphics::Surface *AviDecoder::decodeNextFrame() {
 		uint32 chunkSize = _fileStream->readUint32LE();
 		queueAudioBuffer(chunkSize);
 		_fileStream->skip(chunkSize & 1); // Alignment
-	} else if (getStreamType(nextTag) == 'dc' || getStreamType(nextTag) == 'id' ||
-	           getStreamType(nextTag) == 'AM' || getStreamType(nextTag) == '32' ||
-			   getStreamType(nextTag) == 'iv') {
+	} else if (isVideoChunk(nextTag)) {
 		// Compressed Frame
 		_curFrame++;
-		uint32 chunkSize = _fileStream->readUint32LE();
-
-		if (chunkSize == 0) // Keep last frame on screen
-			return NULL;
-
-		Common::SeekableReadStream *frameData = _fileStream->readStream(chunkSize);
-		const Graphics::Surface *surface = _videoCodec->decodeImage(frameData);
-		delete frameData;
-		_fileStream->skip(chunkSize & 1); // Alignment
-		return surface;
+		return decodeFrameChunk(_fileStream->readUint32LE());
 	} else if (getStreamType(nextTag) == 'pc') {
 		// Palette Change
-		_fileStream->readUint32LE(); // Chunk size, not needed here
-		byte firstEntry = _fileStream->readByte();
-		uint16 numEntries = _fileStream->readByte();
-		_fileStream->readUint16LE(); // Reserved
-
-		// 0 entries means all colors are going to be changed
-		if (numEntries == 0)
-			numEntries = 256;
-
-		for (uint16 i = firstEntry; i < numEntries + firstEntry; i++) {
-			_palette[i * 3] = _fileStream->readByte();
-			_palette[i * 3 + 1] = _fileStream->readByte();
-			_palette[i * 3 + 2] = _fileStream->readByte();
-			_fileStream->readByte(); // Flags that don't serve us any purpose
-		}
-
-		_dirtyPalette = true;
-
-		// No alignment necessary. It's always even.
-	} else if (nextTag == ID_JUNK) {
-		runHandle(ID_JUNK);
-	} else if (nextTag == ID_IDX1) {
-		runHandle(ID_IDX1);
+		handlePalChange();
+	} else if (nextTag == ID_JUNK || nextTag == ID_IDX1) {
+		// The index has already been read when loading
+		uint32 chunkSize = _fileStream->readUint32LE();
+		_fileStream->skip(chunkSize + (chunkSize & 1)); // Alignment
 	} else
 		error("Tag = \'%s\', %d", tag2str(nextTag), _fileStream->pos());
 
 	return NULL;
 }
 
+const Graphics::Surface *AviDecoder::decodeFrameChunk(uint32 chunkSize) {
+	if (chunkSize == 0) // Keep last frame on screen
+		return NULL;
+
+	if (!_framePacket.read(*_fileStream, chunkSize)) {
+		// Truncated file, don't give the codec a partial frame
+		warning("Could not read %d bytes of data for frame %d", chunkSize, getCurFrame());
+		return NULL;
+	}
+
+	const Graphics::Surface *surface = _videoCodec->decodePacket(_framePacket.getData(), _framePacket.getSize());
+	_fileStream->skip(chunkSize & 1); // Alignment
+	return surface;
+}
+
+void AviDecoder::handlePalChange() {
+	_fileStream->readUint32LE(); // Chunk size, not needed here
+	byte firstEntry = _fileStream->readByte();
+	uint16 numEntries = _fileStream->readByte();
+	_fileStream->readUint16LE(); // Reserved
+
+	// 0 entries means all colors are going to be changed
+	if (numEntries == 0)
+		numEntries = 256;
+
+	for (uint16 i = firstEntry; i < numEntries + firstEntry; i++) {
+		_palette[i * 3] = _fileStream->readByte();
+		_palette[i * 3 + 1] = _fileStream->readByte();
+		_palette[i * 3 + 2] = _fileStream->readByte();
+		_fileStream->readByte(); // Flags that don't serve us any purpose
+	}
+
+	_dirtyPalette = true;
+
+	// No alignment necessary. It's always even.
+}
+
 Codec *AviDecoder::createCodec() {
 	switch (_vidsHeader.streamHandler) {
 		case ID_CRAM:
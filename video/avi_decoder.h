@@ -28,7 +28,10 @@
 #include "common/rect.h"
 #include "common/str.h"
 
+#include "common/array.h"
+
 #include "video/video_decoder.h"
+#include "video/codecs/codec.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -49,8 +52,6 @@ struct Surface;
 
 namespace Video {
 
-class Codec;
-
 #define UNKNOWN_HEADER(a) error("Unknown header found -- \'%s\'", tag2str(a))
 
 // IDs used throughout the AVI files
@@ -128,7 +129,7 @@ struct AVIOLDINDEX {
 
 // Index Flags
 enum IndexFlags {
-	AVIIF_INDEX = 0x10
+	AVIIF_INDEX = 0x10 // The chunk is a key frame
 };
 
 // Audio Codecs
@@ -183,10 +184,13 @@ struct AVIStreamHeader {
 /**
  * Decoder for AVI videos.
  *
+ * Seeking requires the file to have an 'idx1' index; without one, only
+ * rewinding is supported.
+ *
  * Video decoder used in engines:
  *  - sci
  */
-class AviDecoder : public FixedRateVideoDecoder {
+class AviDecoder : public FixedRateVideoDecoder, public SeekableVideoDecoder {
 public:
 	AviDecoder(Audio::Mixer *mixer,
 			Audio::Mixer::SoundType soundType = Audio::Mixer::kPlainSoundType);
@@ -205,6 +209,10 @@ public:
 	const byte *getPalette() { _dirtyPalette = false; return _palette; }
 	bool hasDirtyPalette() const { return _dirtyPalette; }
 
+	// SeekableVideoDecoder API
+	void seekToTime(Audio::Timestamp time);
+	uint32 getDuration() const;
+
 protected:
 	Common::Rational getFrameRate() const { return Common::Rational(_vidsHeader.rate, _vidsHeader.scale); }
 
@@ -217,13 +225,29 @@ private:
 	AVIStreamHeader _vidsHeader;
 	AVIStreamHeader _audsHeader;
 	byte _palette[3 * 256];
+	/** The palette from the stream format, before any palette changes */
+	byte _initialPalette[3 * 256];
 	bool _dirtyPalette;
 
 	Common::SeekableReadStream *_fileStream;
 	bool _decodedHeader;
 
+	/** Position of the 'movi' LIST type, which index offsets are relative to */
+	uint32 _movieListStart;
+	/** Position right after the 'movi' LIST */
+	uint32 _movieListEnd;
+	/** For each video frame, the number of its chunk in _ixInfo */
+	Common::Array<uint32> _frameChunks;
+
+	void readIndex();
+	void seekToFrame(uint32 frame);
+	/** Restore the palette as it is before the chunk endChunk of the index */
+	void replayPalChanges(uint32 endChunk);
+	const Graphics::Surface *decodeFrameChunk(uint32 chunkSize);
+
 	Codec *_videoCodec;
 	Codec *createCodec();
+	PacketBuffer _framePacket;
 
 	Audio::Mixer::SoundType _soundType;
 
@@ -236,6 +260,9 @@ private:
 	Audio::QueuingAudioStream *_audStream;
 	Audio::QueuingAudioStream *createAudioStream();
 	void queueAudioBuffer(uint32 chunkSize);
+	/** Restart the audio stream, which now starts at startTime ms */
+	void restartAudio(uint32 startTime);
+	uint32 _audioStartOffset;
 };
 
 } // End of namespace Video
@@ -810,18 +810,26 @@ void BinkDecoder::blockScaledIntra(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	if (readDCTCoeffs(*ctx.video, block, true) == 0) {
+		// Only a DC coefficient, so the whole block has the same value
+		byte v = IDCTDC(block[0]);
 
-	IDCT(block);
+		byte *dest = ctx.dest;
+		for (int i = 0; i < 16; i++, dest += ctx.pitch)
+			memset(dest, v, 16);
 
-	int16 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
+		return;
+	}
+
+	IDCT(block);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+	int16 *src  = block;
+	byte  *dest = ctx.dest;
+	for (int j = 0; j < 8; j++, dest += ctx.pitch << 1, src += 8) {
+		for (int i = 0; i < 8; i++)
+			dest[2 * i] = dest[2 * i + 1] = src[i];
 
+		memcpy(dest + ctx.pitch, dest, 16);
 	}
 }
 
@@ -839,29 +847,29 @@ void BinkDecoder::blockScaledPattern(DecodeContext &ctx) {
 	for (int i = 0; i < 2; i++)
 		col[i] = getBundleValue(kSourceColors);
 
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
+	byte *dest = ctx.dest;
+	for (int j = 0; j < 8; j++, dest += ctx.pitch << 1) {
 		byte v = getBundleValue(kSourcePattern);
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2, v >>= 1)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = col[v & 1];
+		for (int i = 0; i < 8; i++, v >>= 1)
+			dest[2 * i] = dest[2 * i + 1] = col[v & 1];
+
+		memcpy(dest + ctx.pitch, dest, 16);
 	}
 }
 
 void BinkDecoder::blockScaledRaw(DecodeContext &ctx) {
-	byte row[8];
-
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
+	const byte *row = _bundles[kSourceColors].curPtr;
 
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
+	byte *dest = ctx.dest;
+	for (int j = 0; j < 8; j++, dest += ctx.pitch << 1, row += 8) {
+		for (int i = 0; i < 8; i++)
+			dest[2 * i] = dest[2 * i + 1] = row[i];
 
-		_bundles[kSourceColors].curPtr += 8;
+		memcpy(dest + ctx.pitch, dest, 16);
 	}
+
+	_bundles[kSourceColors].curPtr += 64;
 }
 
 void BinkDecoder::blockScaled(DecodeContext &ctx) {
@@ -960,7 +968,16 @@ void BinkDecoder::blockIntra(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
-	readDCTCoeffs(*ctx.video, block, true);
+	if (readDCTCoeffs(*ctx.video, block, true) == 0) {
+		// Only a DC coefficient, so the whole block has the same value
+		byte v = IDCTDC(block[0]);
+
+		byte *dest = ctx.dest;
+		for (int i = 0; i < 8; i++, dest += ctx.pitch)
+			memset(dest, v, 8);
+
+		return;
+	}
 
 	IDCTPut(ctx, block);
 }
@@ -981,7 +998,17 @@ void BinkDecoder::blockInter(DecodeContext &ctx) {
 
 	block[0] = getBundleValue(kSourceInterDC);
 
-	readDCTCoeffs(*ctx.video, block, false);
+	if (readDCTCoeffs(*ctx.video, block, false) == 0) {
+		// Only a DC coefficient, so the same value is added to the whole block
+		byte v = IDCTDC(block[0]);
+
+		byte *dest = ctx.dest;
+		for (int i = 0; i < 8; i++, dest += ctx.pitch)
+			for (int j = 0; j < 8; j++)
+				dest[j] += v;
+
+		return;
+	}
 
 	IDCTAdd(ctx, block);
 }
@@ -1211,8 +1238,8 @@ void BinkDecoder::readDCS(VideoFrame &video, Bundle &bundle, int startBits, bool
 	bundle.curDec = (byte *) dest;
 }
 
-/** Reads 8x8 block of DCT coefficients. */
-void BinkDecoder::readDCTCoeffs(VideoFrame &video, int16 *block, bool isIntra) {
+/** Reads 8x8 block of DCT coefficients, and returns the number of AC coefficients read. */
+int BinkDecoder::readDCTCoeffs(VideoFrame &video, int16 *block, bool isIntra) {
 	int coefCount = 0;
 	int coefIdx[64];
 
@@ -1307,6 +1334,7 @@ void BinkDecoder::readDCTCoeffs(VideoFrame &video, int16 *block, bool isIntra) {
 		block[binkScan[idx]] = (block[binkScan[idx]] * quant[idx]) >> 11;
 	}
 
+	return coefCount;
 }
 
 /** Reads 8x8 block with residue after motion compensation. */
@@ -1445,8 +1473,10 @@ void BinkDecoder::audioBlockDCT(AudioTrack &audio) {
 
 		audio.dct->calc(coeffs);
 
+		// A power of two, so this is exact in single precision too
+		const float scale = audio.frameLen / 2.0f;
 		for (uint32 j = 0; j < audio.frameLen; j++)
-			coeffs[j] *= (audio.frameLen / 2.0);
+			coeffs[j] *= scale;
 	}
 
 }
@@ -1600,35 +1630,60 @@ static inline void IDCTCol(int16 *dest, const int16 *src)
 	}
 }
 
+// Rows without AC coefficients are common, since most of the blocks only
+// have coefficients in the first column. Like the columns above, those
+// just spread the DC value.
+template<typename T>
+static inline void IDCTRow(T *dest, const int16 *src)
+{
+	if ((src[1] | src[2] | src[3] | src[4] | src[5] | src[6] | src[7]) == 0) {
+		const T v = MUNGE_ROW(src[0]);
+		dest[0] = dest[1] = dest[2] = dest[3] = dest[4] = dest[5] = dest[6] = dest[7] = v;
+	} else {
+		IDCT_ROW(dest, src);
+	}
+}
+
+byte BinkDecoder::IDCTDC(int16 dc) {
+	// With only a DC coefficient, the columns just spread it, and so do the rows
+	return MUNGE_ROW(dc);
+}
+
 void BinkDecoder::IDCT(int16 *block) {
 	int i;
 	int16 temp[64];
 
 	for (i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
+	for (i = 0; i < 8; i++)
+		IDCTRow(&block[8 * i], &temp[8 * i]);
 }
 
 void BinkDecoder::IDCTAdd(DecodeContext &ctx, int16 *block) {
 	int i, j;
+	int16 temp[64];
+	int16 row[8];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
 
-	IDCT(block);
 	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
+	for (i = 0; i < 8; i++, dest += ctx.pitch) {
+		IDCTRow(row, &temp[8 * i]);
+
 		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
+			dest[j] += row[j];
+	}
 }
 
 void BinkDecoder::IDCTPut(DecodeContext &ctx, int16 *block) {
 	int i;
 	int16 temp[64];
+
 	for (i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
+	for (i = 0; i < 8; i++)
+		IDCTRow(&ctx.dest[i * ctx.pitch], &temp[8 * i]);
 }
 
 } // End of namespace Video
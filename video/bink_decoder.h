@@ -34,13 +34,13 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h"
 #include "common/array.h"
+#include "common/bitstream.h"
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
 
 namespace Common {
 	class SeekableReadStream;
-	class BitStream;
 	class Huffman;
 
 	class RDFT;
@@ -146,7 +146,7 @@ private:
 
 		uint32 sampleCount;
 
-		Common::BitStream *bits;
+		Common::BitStream32LE *bits;
 
 		bool first;
 
@@ -179,7 +179,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream *bits;
+		Common::BitStream32LE *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -303,7 +303,7 @@ private:
 	void readPatterns    (VideoFrame &video, Bundle &bundle);
 	void readColors      (VideoFrame &video, Bundle &bundle);
 	void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
-	void readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
+	int  readDCTCoeffs   (VideoFrame &video, int16 *block, bool isIntra);
 	void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
 	void initAudioTrack(AudioTrack &audio);
@@ -323,6 +323,7 @@ private:
 
 	// Bink video IDCT
 	void IDCT(int16 *block);
+	static byte IDCTDC(int16 dc);
 	void IDCTPut(DecodeContext &ctx, int16 *block);
 	void IDCTAdd(DecodeContext &ctx, int16 *block);
 };
@@ -41,16 +41,6 @@ inline static void CPYUV2RGB(byte y, byte u, byte v, byte &r, byte &g, byte &b)
 	b = CLIP<int>(y + 2 * (u - 128), 0, 255);
 }
 
-#define PUT_PIXEL(offset, lum, u, v) \
-	if (_pixelFormat.bytesPerPixel != 1) { \
-		CPYUV2RGB(lum, u, v, r, g, b); \
-		if (_pixelFormat.bytesPerPixel == 2) \
-			*((uint16 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-		else \
-			*((uint32 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-	} else \
-		*((byte *)_curFrame.surface->pixels + offset) = lum
-
 CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec() {
 	_curFrame.surface = NULL;
 	_curFrame.strips = NULL;
@@ -100,10 +90,8 @@ const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream
 
 	for (uint16 i = 0; i < _curFrame.stripCount; i++) {
 		if (i > 0 && !(_curFrame.flags & 1)) { // Use codebooks from last strip
-			for (uint16 j = 0; j < 256; j++) {
-				_curFrame.strips[i].v1_codebook[j] = _curFrame.strips[i - 1].v1_codebook[j];
-				_curFrame.strips[i].v4_codebook[j] = _curFrame.strips[i - 1].v4_codebook[j];
-			}
+			memcpy(_curFrame.strips[i].v1_codebook, _curFrame.strips[i - 1].v1_codebook, sizeof(_curFrame.strips[i].v1_codebook));
+			memcpy(_curFrame.strips[i].v4_codebook, _curFrame.strips[i - 1].v4_codebook, sizeof(_curFrame.strips[i].v4_codebook));
 		}
 
 		_curFrame.strips[i].id = stream->readUint16BE();
@@ -146,7 +134,12 @@ const Graphics::Surface *CinepakDecoder::decodeImage(Common::SeekableReadStream
 			case 0x30:
 			case 0x31:
 			case 0x32:
-				decodeVectors(stream, i, chunkID, chunkSize);
+				if (_pixelFormat.bytesPerPixel == 1)
+					decodeVectors<byte>(stream, i, chunkID, chunkSize);
+				else if (_pixelFormat.bytesPerPixel == 2)
+					decodeVectors<uint16>(stream, i, chunkID, chunkSize);
+				else
+					decodeVectors<uint32>(stream, i, chunkID, chunkSize);
 				break;
 			default:
 				warning("Unknown Cinepak chunk ID %02x", chunkID);
@@ -196,98 +189,83 @@ void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 str
 				codebook[i].u  = 128;
 				codebook[i].v  = 128;
 			}
+
+			// Convert the pixels once here, instead of every time they're used
+			for (byte j = 0; j < 4; j++) {
+				if (_pixelFormat.bytesPerPixel == 1) {
+					codebook[i].color[j] = codebook[i].y[j];
+				} else {
+					byte r, g, b;
+					CPYUV2RGB(codebook[i].y[j], codebook[i].u, codebook[i].v, r, g, b);
+					codebook[i].color[j] = _pixelFormat.RGBToColor(r, g, b);
+				}
+			}
 		}
 	}
 }
 
+template<typename PixelInt>
 void CinepakDecoder::decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize) {
 	uint32 flag = 0, mask = 0;
-	uint32 iy[4];
-	int32 startPos = stream->pos();
-	byte r = 0, g = 0, b = 0;
+	int32 bytesLeft = chunkSize;
+	const CinepakCodebook *v1Codebook = _curFrame.strips[strip].v1_codebook;
+	const CinepakCodebook *v4Codebook = _curFrame.strips[strip].v4_codebook;
+	const Common::Rect &rect = _curFrame.strips[strip].rect;
+	const uint16 width = _curFrame.width;
 
-	for (uint16 y = _curFrame.strips[strip].rect.top; y < _curFrame.strips[strip].rect.bottom; y += 4) {
-		iy[0] = _curFrame.strips[strip].rect.left + y * _curFrame.width;
-		iy[1] = iy[0] + _curFrame.width;
-		iy[2] = iy[1] + _curFrame.width;
-		iy[3] = iy[2] + _curFrame.width;
+	for (uint16 y = rect.top; y < rect.bottom; y += 4) {
+		PixelInt *dst = (PixelInt *)_curFrame.surface->pixels + rect.left + y * width;
 
-		for (uint16 x = _curFrame.strips[strip].rect.left; x < _curFrame.strips[strip].rect.right; x += 4) {
+		for (uint16 x = rect.left; x < rect.right; x += 4, dst += 4) {
 			if ((chunkID & 0x01) && !(mask >>= 1)) {
-				if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+				if (bytesLeft < 4)
 					return;
 
 				flag  = stream->readUint32BE();
 				mask  = 0x80000000;
+				bytesLeft -= 4;
 			}
 
 			if (!(chunkID & 0x01) || (flag & mask)) {
 				if (!(chunkID & 0x02) && !(mask >>= 1)) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (bytesLeft < 4)
 						return;
 
 					flag  = stream->readUint32BE();
 					mask  = 0x80000000;
+					bytesLeft -= 4;
 				}
 
 				if ((chunkID & 0x02) || (~flag & mask)) {
-					if ((stream->pos() - startPos + 1) > (int32)chunkSize)
+					if (bytesLeft < 1)
 						return;
 
-					// Get the codebook
-					CinepakCodebook codebook = _curFrame.strips[strip].v1_codebook[stream->readByte()];
-
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[0], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[0] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[1], codebook.u, codebook.v);
+					// Each pixel of the codebook covers 2x2 pixels
+					const uint32 *color = v1Codebook[stream->readByte()].color;
+					bytesLeft--;
 
-					PUT_PIXEL(iy[2] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[2], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					for (int i = 0; i < 4; i += 2) {
+						PixelInt *line = dst + (i * width);
+						line[0] = line[1] = line[width] = line[width + 1] = color[i];
+						line[2] = line[3] = line[width + 2] = line[width + 3] = color[i + 1];
+					}
 				} else if (flag & mask) {
-					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
+					if (bytesLeft < 4)
 						return;
 
-					CinepakCodebook codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					// Four codebooks, one for each 2x2 quarter
+					for (int i = 0; i < 4; i++) {
+						const uint32 *color = v4Codebook[stream->readByte()].color;
+						PixelInt *quarter = dst + ((i >> 1) * 2 * width) + ((i & 1) * 2);
+						quarter[0] = color[0];
+						quarter[1] = color[1];
+						quarter[width] = color[2];
+						quarter[width + 1] = color[3];
+					}
+
+					bytesLeft -= 4;
 				}
 			}
-
-			for (byte i = 0; i < 4; i++)
-				iy[i] += 4;
 		}
 	}
 }
@@ -42,6 +42,9 @@ namespace Video {
 struct CinepakCodebook {
 	byte y[4];
 	byte u, v;
+
+	// The four pixels in the output format, converted when the codebook is loaded
+	uint32 color[4];
 };
 
 struct CinepakStrip {
@@ -76,6 +79,8 @@ private:
 	Graphics::PixelFormat _pixelFormat;
 
 	void loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
+
+	template<typename PixelInt>
 	void decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize);
 };
 
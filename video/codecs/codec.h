@@ -23,13 +23,13 @@
 #ifndef VIDEO_CODECS_CODEC_H
 #define VIDEO_CODECS_CODEC_H
 
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/stream.h"
+
 #include "graphics/surface.h"
 #include "graphics/pixelformat.h"
 
-namespace Common {
-class SeekableReadStream;
-}
-
 namespace Video {
 
 class Codec {
@@ -40,11 +40,67 @@ public:
 	virtual const Graphics::Surface *decodeImage(Common::SeekableReadStream *stream) = 0;
 	virtual Graphics::PixelFormat getPixelFormat() const = 0;
 
+	/**
+	 * Decode a frame from a packet in memory. Codecs which can parse the
+	 * data directly may override this, so the packet doesn't have to go
+	 * through a stream.
+	 *
+	 * @param data	the packet data, which only has to stay valid during the call
+	 * @param size	the size of the packet in bytes
+	 */
+	virtual const Graphics::Surface *decodePacket(const byte *data, uint32 size) {
+		Common::MemoryReadStream stream(data, size);
+		return decodeImage(&stream);
+	}
+
 	virtual bool containsPalette() const { return false; }
 	virtual const byte *getPalette() { return 0; }
 	virtual bool hasDirtyPalette() const { return false; }
 };
 
+/**
+ * A buffer for the packets which a container passes to its codec. It is
+ * reused for every packet, so that no memory is allocated per frame.
+ */
+class PacketBuffer : Common::NonCopyable {
+public:
+	PacketBuffer() : _data(0), _size(0), _capacity(0) {}
+	~PacketBuffer() { delete[] _data; }
+
+	/**
+	 * Read a packet from a stream into the buffer.
+	 *
+	 * @return false if the stream ended before the whole packet was read
+	 */
+	bool read(Common::ReadStream &stream, uint32 size) {
+		if (size > _capacity) {
+			delete[] _data;
+
+			// Leave some room, so slowly growing packets don't reallocate every time
+			_capacity = size + size / 4;
+			_data = new byte[_capacity];
+		}
+
+		_size = stream.read(_data, size);
+		return _size == size;
+	}
+
+	const byte *getData() const { return _data; }
+	uint32 getSize() const { return _size; }
+
+	/** Free the buffer, e.g. when the video is closed. */
+	void clear() {
+		delete[] _data;
+		_data = 0;
+		_size = _capacity = 0;
+	}
+
+private:
+	byte *_data;
+	uint32 _size;
+	uint32 _capacity;
+};
+
 } // End of namespace Video
 
 #endif
@@ -30,6 +30,7 @@
 
 #include "common/system.h"
 #include "common/endian.h"
+#include "common/memstream.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -49,6 +50,7 @@ Indeo3Decoder::Indeo3Decoder(uint16 width, uint16 height) : _ModPred(0), _correc
 	_surface->create(width, height, _pixelFormat);
 
 	buildModPred();
+	buildColorTables();
 	allocFrames();
 }
 
@@ -113,6 +115,26 @@ void Indeo3Decoder::buildModPred() {
 	}
 }
 
+void Indeo3Decoder::buildColorTables() {
+	// The chroma parts of Graphics::YUV2RGB()
+	for (int i = 0; i < 256; i++) {
+		_vToR[i] =  (1357 * (i - 128)) >> 10;
+		_vToG[i] = -(( 691 * (i - 128)) >> 10);
+		_uToG[i] = -(( 333 * (i - 128)) >> 10);
+		_uToB[i] =  (1715 * (i - 128)) >> 10;
+	}
+
+	// Clip the components and convert them to the pixel format. The
+	// chroma parts are within [-214, 214], so this covers all sums.
+	for (int i = 0; i < 768; i++) {
+		byte c = CLIP<int>(i - 256, 0, 255);
+
+		_rToColor[i] = _pixelFormat.RGBToColor(c, 0, 0);
+		_gToColor[i] = _pixelFormat.RGBToColor(0, c, 0);
+		_bToColor[i] = _pixelFormat.RGBToColor(0, 0, c);
+	}
+}
+
 void Indeo3Decoder::allocFrames() {
 	int32 luma_width   = (_surface->w + 3) & (~3);
 	int32 luma_height  = (_surface->h + 3) & (~3);
@@ -165,6 +187,26 @@ void Indeo3Decoder::allocFrames() {
 }
 
 const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *stream) {
+	uint32 dataSize = stream->size();
+	byte *data = new byte[dataSize];
+
+	stream->seek(0);
+	if (stream->read(data, dataSize) != dataSize) {
+		delete[] data;
+		return 0;
+	}
+
+	const Graphics::Surface *surface = decodePacket(data, dataSize);
+
+	delete[] data;
+	return surface;
+}
+
+const Graphics::Surface *Indeo3Decoder::decodePacket(const byte *data, uint32 size) {
+	// The header is read through a stream, the plane data is used in place
+	Common::MemoryReadStream headerStream(data, size);
+	Common::SeekableReadStream *stream = &headerStream;
+
 	// Not Indeo 3? Fail
 	if (!isIndeo3(*stream))
 		return 0;
@@ -225,42 +267,48 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 		return 0;
 	}
 
-	uint32 dataSize = stream->size() - hPos;
-
-	byte *inData = new byte[dataSize];
-
-	if (stream->read(inData, dataSize) != dataSize) {
-		delete[] inData;
-		return 0;
-	}
-
-	byte *hdr_pos = inData;
-	byte *buf_pos;
+	const byte *hdr_pos = data + hPos;
+	const byte *buf_pos;
 
 	// Luminance Y
 	stream->seek(offsY);
-	buf_pos = inData + offsY + 4 - hPos;
+	buf_pos = data + offsY + 4;
 	offs = stream->readUint32LE();
 	decodeChunk(_cur_frame->Ybuf, _ref_frame->Ybuf, fWidth, fHeight,
 			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(fWidth, 160));
 
 	// Chrominance U
 	stream->seek(offsU);
-	buf_pos = inData + offsU + 4 - hPos;
+	buf_pos = data + offsU + 4;
 	offs = stream->readUint32LE();
 	decodeChunk(_cur_frame->Vbuf, _ref_frame->Vbuf, chromaWidth, chromaHeight,
 			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(chromaWidth, 40));
 
 	// Chrominance V
 	stream->seek(offsV);
-	buf_pos = inData + offsV + 4 - hPos;
+	buf_pos = data + offsV + 4;
 	offs = stream->readUint32LE();
 	decodeChunk(_cur_frame->Ubuf, _ref_frame->Ubuf, chromaWidth, chromaHeight,
 			buf_pos + offs * 2, flags2, hdr_pos, buf_pos, MIN<int>(chromaWidth, 40));
 
-	delete[] inData;
-
 	// Blit the frame onto the surface
+	switch (_surface->format.bytesPerPixel) {
+	case 1:
+		blitFrame<uint8>(fWidth, fHeight, chromaWidth);
+		break;
+	case 2:
+		blitFrame<uint16>(fWidth, fHeight, chromaWidth);
+		break;
+	case 4:
+		blitFrame<uint32>(fWidth, fHeight, chromaWidth);
+		break;
+	}
+
+	return _surface;
+}
+
+template<typename PixelInt>
+void Indeo3Decoder::blitFrame(uint32 fWidth, uint32 fHeight, uint32 chromaWidth) {
 	const byte *srcY = _cur_frame->Ybuf;
 	const byte *srcU = _cur_frame->Ubuf;
 	const byte *srcV = _cur_frame->Vbuf;
@@ -274,55 +322,54 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 	uint32 scaleWidth  = _surface->w / fWidth;
 	uint32 scaleHeight = _surface->h / fHeight;
 
+	// The chroma contribution to each component, for one line
+	int16 *lineR = new int16[fWidth * 3];
+	int16 *lineG = lineR + fWidth;
+	int16 *lineB = lineG + fWidth;
+
 	for (uint32 y = 0; y < fHeight; y++) {
-		byte *rowDest = dest;
+		// The chroma of the outer columns and lines of each 4x4 block is
+		// averaged with its neighbor. The middle two lines of a block are
+		// the same, so they share their chroma.
+		if ((y & 3) != 2) {
+			const byte *srcUA = srcU;
+			const byte *srcVA = srcV;
+
+			if ((y & 3) == 0) {
+				srcUA = srcUP;
+				srcVA = srcVP;
+			} else if ((y & 3) == 3) {
+				srcUA = srcUN;
+				srcVA = srcVN;
+			}
 
-		for (uint32 sH = 0; sH < scaleHeight; sH++) {
 			for (uint32 x = 0; x < fWidth; x++) {
-				uint32 xP = MAX<int32>((x >> 2) - 1, 0);
-				uint32 xN = MIN<int32>((x >> 2) + 1, chromaWidth - 1);
-
-				byte cY = srcY[x];
-				byte cU = srcU[x >> 2];
-				byte cV = srcV[x >> 2];
-
-				if        (((x % 4) == 0) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xN])) / 2;
-				} else if (((x % 4) == 0) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xN])) / 2;
-				} else if ( (x % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcU[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xP])) / 2;
-				} else if ( (x % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcU[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xN])) / 2;
-				} else if ( (y % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcUP[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[x >> 2])) / 2;
-				} else if ( (y % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcUN[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[x >> 2])) / 2;
-				}
+				uint32 xA = x >> 2;
 
-				byte r = 0, g = 0, b = 0;
-				Graphics::YUV2RGB(cY, cU, cV, r, g, b);
+				if ((x & 3) == 0)
+					xA = MAX<int32>((x >> 2) - 1, 0);
+				else if ((x & 3) == 3)
+					xA = MIN<int32>((x >> 2) + 1, chromaWidth - 1);
 
-				const uint32 color = _pixelFormat.RGBToColor(r, g, b);
+				// Averaging a value with itself keeps it as it is
+				byte cU = (((uint32) srcU[x >> 2]) + ((uint32) srcUA[xA])) / 2;
+				byte cV = (((uint32) srcV[x >> 2]) + ((uint32) srcVA[xA])) / 2;
 
-				for (uint32 sW = 0; sW < scaleWidth; sW++, rowDest += _surface->format.bytesPerPixel) {
-					if      (_surface->format.bytesPerPixel == 1)
-						*((uint8 *)rowDest) = (uint8)color;
-					else if (_surface->format.bytesPerPixel == 2)
-						*((uint16 *)rowDest) = (uint16)color;
-				}
+				lineR[x] = _vToR[cV] + 256;
+				lineG[x] = _vToG[cV] + _uToG[cU] + 256;
+				lineB[x] = _uToB[cU] + 256;
+			}
+		}
+
+		for (uint32 sH = 0; sH < scaleHeight; sH++) {
+			PixelInt *rowDest = (PixelInt *)dest;
+
+			for (uint32 x = 0; x < fWidth; x++) {
+				const byte cY = srcY[x];
+				const PixelInt color = _rToColor[cY + lineR[x]] | _gToColor[cY + lineG[x]] | _bToColor[cY + lineB[x]];
+
+				for (uint32 sW = 0; sW < scaleWidth; sW++)
+					*rowDest++ = color;
 			}
 
 			dest += _surface->pitch;
@@ -345,7 +392,7 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 		}
 	}
 
-	return _surface;
+	delete[] lineR;
 }
 
 typedef struct {
@@ -506,11 +553,13 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 			cmd = (bit_buf >> bit_pos) & 0x03;
 
 			if (cmd == 0 || ref_vectors != NULL) {
-				for (lp1 = 0; lp1 < blks_width; lp1++) {
-					for (i = 0, j = 0; i < blks_height; i++, j += width_tbl[1])
-						((uint32 *)cur_frm_pos)[j] = ((uint32 *)ref_frm_pos)[j];
-					cur_frm_pos += 4;
-					ref_frm_pos += 4;
+				// Copy the cell line by line. Without a motion vector, the
+				// reference is the line above in the same buffer, which has
+				// always been written before it's read.
+				for (i = 0; i < blks_height; i++) {
+					memcpy(cur_frm_pos, ref_frm_pos, blks_width << 2);
+					cur_frm_pos += width_tbl[1] << 2;
+					ref_frm_pos += width_tbl[1] << 2;
 				}
 			} else if (cmd != 1)
 				return;
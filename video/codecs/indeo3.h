@@ -42,6 +42,7 @@ public:
 	~Indeo3Decoder();
 
 	const Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
+	const Graphics::Surface *decodePacket(const byte *data, uint32 size);
 	Graphics::PixelFormat getPixelFormat() const;
 
 	static bool isIndeo3(Common::SeekableReadStream &stream);
@@ -74,9 +75,17 @@ private:
 	byte *_ModPred;
 	uint16 *_corrector_type;
 
+	// Lookup tables for converting the frame to the pixel format
+	int16 _vToR[256], _vToG[256], _uToG[256], _uToB[256];
+	uint32 _rToColor[768], _gToColor[768], _bToColor[768];
+
 	void buildModPred();
+	void buildColorTables();
 	void allocFrames();
 
+	template<typename PixelInt>
+	void blitFrame(uint32 fWidth, uint32 fHeight, uint32 chromaWidth);
+
 	void decodeChunk(byte *cur, byte *ref, int width, int height,
 			const byte *buf1, uint32 fflags2, const byte *hdr,
 			const byte *buf2, int min_width_160);
@@ -59,13 +59,11 @@ const Graphics::Surface *JPEGDecoder::decodeImage(Common::SeekableReadStream* st
 		_surface->create(_jpeg->getWidth(), _jpeg->getHeight(), _pixelFormat);
 	}
 
-	Graphics::Surface *frame = _jpeg->getSurface(_pixelFormat);
-	assert(frame);
-
-	_surface->copyFrom(*frame);
-
-	frame->free();
-	delete frame;
+	// Convert straight into our surface instead of a new one every frame
+	if (!_jpeg->convertToSurface(*_surface)) {
+		warning("Failed to convert JPEG frame");
+		return 0;
+	}
 
 	return _surface;
 }
@@ -2199,8 +2199,7 @@ bool VMDDecoder::renderFrame(Common::Rect &rect) {
 		if (!_codec)
 			return false;
 
-		Common::MemoryReadStream frameStream(_videoBuffer[0], _videoBufferLen[0]);
-		const Graphics::Surface *codecSurf = _codec->decodeImage(&frameStream);
+		const Graphics::Surface *codecSurf = _codec->decodePacket(_videoBuffer[0], _videoBufferLen[0]);
 		if (!codecSurf)
 			return false;
 
@@ -107,18 +107,12 @@ uint32 QuickTimeDecoder::getFrameDuration() {
 	if (_videoTrackIndex < 0)
 		return 0;
 
-	uint32 curFrameIndex = 0;
-	for (int32 i = 0; i < _tracks[_videoTrackIndex]->timeToSampleCount; i++) {
-		curFrameIndex += _tracks[_videoTrackIndex]->timeToSample[i].count;
-		if ((uint32)_curFrame < curFrameIndex) {
-			// Ok, now we have what duration this frame has.
-			return _tracks[_videoTrackIndex]->timeToSample[i].duration;
-		}
+	if ((uint32)_curFrame >= _tracks[_videoTrackIndex]->frameCount) {
+		// This should never occur
+		error ("Cannot find duration for frame %d", _curFrame);
 	}
 
-	// This should never occur
-	error ("Cannot find duration for frame %d", _curFrame);
-	return 0;
+	return getSampleDuration(_tracks[_videoTrackIndex], _curFrame);
 }
 
 Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
@@ -131,12 +125,7 @@ Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
 }
 
 uint32 QuickTimeDecoder::findKeyFrame(uint32 frame) const {
-	for (int i = _tracks[_videoTrackIndex]->keyframeCount - 1; i >= 0; i--)
-		if (_tracks[_videoTrackIndex]->keyframes[i] <= frame)
-				return _tracks[_videoTrackIndex]->keyframes[i];
-
-	// If none found, we'll assume the requested frame is a key frame
-	return frame;
+	return Common::QuickTimeParser::findKeyFrame(_tracks[_videoTrackIndex], frame);
 }
 
 void QuickTimeDecoder::seekToFrame(uint32 frame) {
@@ -146,21 +135,23 @@ void QuickTimeDecoder::seekToFrame(uint32 frame) {
 	// Stop all audio (for now)
 	stopAudio();
 
-	// Track down the keyframe
-	_curFrame = findKeyFrame(frame) - 1;
+	// Track down the keyframe. If there's none between the last decoded
+	// frame and the requested one, just keep decoding from where we are.
+	int32 keyFrame = findKeyFrame(frame);
+	if (_curFrame + 1 < keyFrame || _curFrame >= (int32)frame)
+		_curFrame = keyFrame - 1;
+
+	int32 startFrame = _curFrame + 1;
+	uint32 startTime = g_system->getMillis();
+
 	while (_curFrame < (int32)frame - 1)
 		decodeNextFrame();
 
-	// Map out the starting point
-	_nextFrameStartTime = 0;
-	uint32 curFrame = 0;
+	debug(3, "QuickTimeDecoder::seekToFrame(): Decoded %d frames from frame %d in %d ms to reach frame %d",
+			frame - startFrame, startFrame, g_system->getMillis() - startTime, frame);
 
-	for (int32 i = 0; i < _tracks[_videoTrackIndex]->timeToSampleCount && curFrame < frame; i++) {
-		for (int32 j = 0; j < _tracks[_videoTrackIndex]->timeToSample[i].count && curFrame < frame; j++) {
-			curFrame++;
-			_nextFrameStartTime += _tracks[_videoTrackIndex]->timeToSample[i].duration;
-		}
-	}
+	// Map out the starting point
+	_nextFrameStartTime = getSampleTime(_tracks[_videoTrackIndex], frame);
 
 	// Adjust the video starting point
 	const Audio::Timestamp curVideoTime(0, _nextFrameStartTime, _tracks[_videoTrackIndex]->timeScale);
@@ -184,23 +175,11 @@ void QuickTimeDecoder::seekToTime(Audio::Timestamp time) {
 	if (_videoTrackIndex < 0)
 		error("Audio-only seeking not supported");
 
-	// Try to find the last frame that should have been decoded
-	uint32 frame = 0;
-	Audio::Timestamp totalDuration(0, _tracks[_videoTrackIndex]->timeScale);
-	bool done = false;
-
-	for (int32 i = 0; i < _tracks[_videoTrackIndex]->timeToSampleCount && !done; i++) {
-		for (int32 j = 0; j < _tracks[_videoTrackIndex]->timeToSample[i].count; j++) {
-			totalDuration = totalDuration.addFrames(_tracks[_videoTrackIndex]->timeToSample[i].duration);
-			if (totalDuration > time) {
-				done = true;
-				break;
-			}
-			frame++;
-		}
-	}
+	// Try to find the last frame that should have been decoded. The frames
+	// start at whole units of the time scale, so convert the time to those.
+	uint32 mediaTime = time.convertToFramerate(_tracks[_videoTrackIndex]->timeScale).totalNumberOfFrames();
 
-	seekToFrame(frame);
+	seekToFrame(findSampleAtTime(_tracks[_videoTrackIndex], mediaTime));
 }
 
 void QuickTimeDecoder::startAudio() {
@@ -242,9 +221,7 @@ const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 
 	// Get the next packet
 	uint32 descId;
-	Common::SeekableReadStream *frameData = getNextFramePacket(descId);
-
-	if (!frameData || !descId || descId > _tracks[_videoTrackIndex]->sampleDescs.size())
+	if (!getNextFramePacket(descId) || !descId || descId > _tracks[_videoTrackIndex]->sampleDescs.size())
 		return 0;
 
 	// Find which video description entry we want
@@ -253,8 +230,7 @@ const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 	if (!entry->_videoCodec)
 		return 0;
 
-	const Graphics::Surface *frame = entry->_videoCodec->decodeImage(frameData);
-	delete frameData;
+	const Graphics::Surface *frame = entry->_videoCodec->decodePacket(_framePacket.getData(), _framePacket.getSize());
 
 	// Update the palette
 	if (entry->_videoCodec->containsPalette()) {
@@ -467,62 +443,42 @@ void QuickTimeDecoder::close() {
 		_scaledSurface = 0;
 	}
 
+	_framePacket.clear();
+
 	Common::QuickTimeParser::close();
 	SeekableVideoDecoder::reset();
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
+bool QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
 	if (_videoTrackIndex < 0)
-		return NULL;
-
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
-
-	for (uint32 i = 0; i < _tracks[_videoTrackIndex]->chunkCount; i++) {
-		int32 sampleToChunkIndex = -1;
-
-		for (uint32 j = 0; j < _tracks[_videoTrackIndex]->sampleToChunkCount; j++)
-			if (i >= _tracks[_videoTrackIndex]->sampleToChunk[j].first)
-				sampleToChunkIndex = j;
-
-		if (sampleToChunkIndex < 0)
-			error("This chunk (%d) is imaginary", sampleToChunkIndex);
-
-		totalSampleCount += _tracks[_videoTrackIndex]->sampleToChunk[sampleToChunkIndex].count;
-
-		if (totalSampleCount > getCurFrame()) {
-			actualChunk = i;
-			descId = _tracks[_videoTrackIndex]->sampleToChunk[sampleToChunkIndex].id;
-			sampleInChunk = _tracks[_videoTrackIndex]->sampleToChunk[sampleToChunkIndex].count - totalSampleCount + getCurFrame();
-			break;
-		}
-	}
+		return false;
 
-	if (actualChunk < 0) {
+	// First, we have to track down where the sample holding the frame is
+	uint32 offset;
+	if (!findSampleOffset(_tracks[_videoTrackIndex], getCurFrame(), offset, descId)) {
 		warning ("Could not find data for frame %d", getCurFrame());
-		return NULL;
+		return false;
 	}
 
 	// Next seek to that frame
-	_fd->seek(_tracks[_videoTrackIndex]->chunkOffsets[actualChunk]);
-
-	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = getCurFrame() - sampleInChunk; i < getCurFrame(); i++) {
-		if (_tracks[_videoTrackIndex]->sampleSize != 0)
-			_fd->skip(_tracks[_videoTrackIndex]->sampleSize);
-		else
-			_fd->skip(_tracks[_videoTrackIndex]->sampleSizes[i]);
-	}
+	_fd->seek(offset);
 
-	// Finally, read in the raw data for the frame
+	// Finally, read in the raw data for the frame. The buffer is reused for
+	// every frame, so the codec gets it without any allocation.
 	//printf ("Frame Data[%d]: Offset = %d, Size = %d\n", getCurFrame(), _fd->pos(), _tracks[_videoTrackIndex]->sampleSizes[getCurFrame()]);
 
+	uint32 size;
 	if (_tracks[_videoTrackIndex]->sampleSize != 0)
-		return _fd->readStream(_tracks[_videoTrackIndex]->sampleSize);
+		size = _tracks[_videoTrackIndex]->sampleSize;
+	else
+		size = _tracks[_videoTrackIndex]->sampleSizes[getCurFrame()];
 
-	return _fd->readStream(_tracks[_videoTrackIndex]->sampleSizes[getCurFrame()]);
+	if (!_framePacket.read(*_fd, size)) {
+		warning("Could not read %d bytes of data for frame %d", size, getCurFrame());
+		return false;
+	}
+
+	return true;
 }
 
 void QuickTimeDecoder::updateAudioBuffer() {
@@ -35,6 +35,7 @@
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
+#include "video/codecs/codec.h"
 
 #include "audio/mixer.h"
 #include "audio/decoders/quicktime_intern.h"
@@ -45,8 +46,6 @@ namespace Common {
 
 namespace Video {
 
-class Codec;
-
 /**
  * Decoder for QuickTime videos.
  *
@@ -132,7 +131,8 @@ protected:
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Track *track, uint32 format);
 
 private:
-	Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
+	bool getNextFramePacket(uint32 &descId);
+	PacketBuffer _framePacket;
 	uint32 getFrameDuration();
 	void init();
 
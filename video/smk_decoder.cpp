@@ -53,66 +53,60 @@ enum SmkBlockTypes {
 class BitStream {
 public:
 	BitStream(byte *buf, uint32 length)
-		: _buf(buf), _end(buf+length), _bitCount(8) {
-		_curByte = *_buf++;
+		: _buf(buf), _end(buf+length), _bitBuf(0), _bitCount(0) {
 	}
 
 	bool getBit();
 	byte getBits8();
 
-	byte peek8() const;
+	/**
+	 * Return the next n (up to 24) bits without consuming them. Bits past
+	 * the end of the buffer read as zero.
+	 */
+	uint32 peekBits(int n);
 	void skip(int n);
 
 private:
+	void fill();
+
 	byte *_buf;
 	byte *_end;
-	byte _curByte;
-	byte  _bitCount;
+
+	/** The buffered bits, the next bit being the lowest one */
+	uint32 _bitBuf;
+	int _bitCount;
 };
 
-bool BitStream::getBit() {
-	if (_bitCount == 0) {
-		assert(_buf < _end);
-		_curByte = *_buf++;
-		_bitCount = 8;
+inline void BitStream::fill() {
+	while (_bitCount <= 24 && _buf < _end) {
+		_bitBuf |= (uint32)*_buf++ << _bitCount;
+		_bitCount += 8;
 	}
-
-	bool v = _curByte & 1;
-
-	_curByte >>= 1;
-	--_bitCount;
-
-	return v;
 }
 
-byte BitStream::getBits8() {
-	assert(_buf < _end);
+inline uint32 BitStream::peekBits(int n) {
+	if (_bitCount < n)
+		fill();
 
-	byte v = (*_buf << _bitCount) | _curByte;
-	_curByte = *_buf++ >> (8 - _bitCount);
-
-	return v;
+	return _bitBuf & ((1 << n) - 1);
 }
 
-byte BitStream::peek8() const {
-	if (_buf == _end)
-		return _curByte;
-
-	assert(_buf < _end);
-	return (*_buf << _bitCount) | _curByte;
+inline void BitStream::skip(int n) {
+	assert(n <= _bitCount);
+	_bitBuf >>= n;
+	_bitCount -= n;
 }
 
-void BitStream::skip(int n) {
-	assert(n <= 8);
-	_curByte >>= n;
+inline bool BitStream::getBit() {
+	bool v = peekBits(1);
+	skip(1);
+	return v;
+}
 
-	if (_bitCount >= n) {
-		_bitCount -= n;
-	} else {
-		assert(_buf < _end);
-		_bitCount = _bitCount + 8 - n;
-		_curByte = *_buf++ >> (8 - _bitCount);
-	}
+inline byte BitStream::getBits8() {
+	byte v = peekBits(8);
+	skip(8);
+	return v;
 }
 
 /*
@@ -130,13 +124,21 @@ private:
 		SMK_NODE = 0x8000
 	};
 
+	enum {
+		/**
+		 * The codes up to this length are decoded with one lookup, the
+		 * longer ones continue bit by bit from the node at this depth
+		 */
+		kLookupBits = 10
+	};
+
 	uint16 decodeTree(uint32 prefix, int length);
 
 	uint16 _treeSize;
 	uint16 _tree[511];
 
-	uint16 _prefixtree[256];
-	byte _prefixlength[256];
+	uint16 _prefixtree[1 << kLookupBits];
+	byte _prefixlength[1 << kLookupBits];
 
 	BitStream &_bs;
 };
@@ -146,8 +148,8 @@ SmallHuffmanTree::SmallHuffmanTree(BitStream &bs)
 	uint32 bit = _bs.getBit();
 	assert(bit);
 
-	for (uint16 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
+	memset(_prefixtree, 0, sizeof(_prefixtree));
+	memset(_prefixlength, 0, sizeof(_prefixlength));
 
 	decodeTree(0, 0);
 
@@ -159,8 +161,8 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 	if (!_bs.getBit()) { // Leaf
 		_tree[_treeSize] = _bs.getBits8();
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kLookupBits) {
+			for (int i = 0; i < (1 << kLookupBits); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -172,9 +174,9 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint16 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kLookupBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kLookupBits;
 	}
 
 	uint16 r1 = decodeTree(prefix, length + 1);
@@ -187,7 +189,7 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint16 SmallHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	uint32 peek = bs.peekBits(kLookupBits);
 	uint16 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -217,14 +219,19 @@ private:
 		SMK_NODE = 0x80000000
 	};
 
+	enum {
+		/** See SmallHuffmanTree::kLookupBits */
+		kLookupBits = 12
+	};
+
 	uint32 decodeTree(uint32 prefix, int length);
 
 	uint32  _treeSize;
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _prefixtree[1 << kLookupBits];
+	byte _prefixlength[1 << kLookupBits];
 
 	/* Used during construction */
 	BitStream &_bs;
@@ -235,6 +242,10 @@ private:
 
 BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 	: _bs(bs) {
+	// An empty tree decodes every code to its single leaf, without using any bits
+	memset(_prefixtree, 0, sizeof(_prefixtree));
+	memset(_prefixlength, 0, sizeof(_prefixlength));
+
 	uint32 bit = _bs.getBit();
 	if (!bit) {
 		_tree = new uint32[1];
@@ -243,9 +254,6 @@ BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
 
@@ -295,8 +303,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kLookupBits) {
+			for (int i = 0; i < (1 << kLookupBits); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -315,9 +323,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kLookupBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kLookupBits;
 	}
 
 	uint32 r1 = decodeTree(prefix, length + 1);
@@ -329,7 +337,7 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint32 BigHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	uint32 peek = bs.peekBits(kLookupBits);
 	uint32 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 